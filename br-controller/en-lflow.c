@@ -166,6 +166,7 @@ br_controller_extend_symtab(struct shash *symtab)
                           "ip6", false);
     expr_symtab_add_field(symtab, "tun_ip6.dst", MFF_TUN_IPV6_DST,
                           "ip6", false);
+    expr_symtab_compile(symtab);
 }
 
 static void
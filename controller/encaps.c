@@ -31,6 +31,61 @@ VLOG_DEFINE_THIS_MODULE(encaps);
 
 static char *current_br_int_name = NULL;
 
+/* encaps_run() only depends on the OVS database, on the SB Chassis, Encap
+ * and SB_Global tables and on the configured transport zones.  The state
+ * seen by the last full run is kept here, so that the walk over all chassis
+ * and all integration bridge ports is skipped while none of it changed,
+ * e.g. on wakeups caused by Port_Binding or Logical_Flow updates. */
+static struct {
+    bool valid;
+    unsigned int ovs_seqno;
+    unsigned int sb_seqno;
+    const struct ovsrec_bridge *br_int;
+    const struct sbrec_chassis *this_chassis;
+    struct sset transport_zones;
+} encaps_synced = {
+    .transport_zones = SSET_INITIALIZER(&encaps_synced.transport_zones),
+};
+
+static unsigned int
+encaps_sb_seqno(const struct ovsdb_idl *ovnsb_idl)
+{
+    return MAX(sbrec_chassis_get_seqno(ovnsb_idl),
+               MAX(sbrec_encap_get_seqno(ovnsb_idl),
+                   sbrec_sb_global_get_seqno(ovnsb_idl)));
+}
+
+static bool
+encaps_inputs_changed(const struct ovsdb_idl *ovs_idl,
+                      const struct ovsdb_idl *ovnsb_idl,
+                      const struct ovsrec_bridge *br_int,
+                      const struct sbrec_chassis *this_chassis,
+                      const struct sset *transport_zones)
+{
+    return !encaps_synced.valid
+           || encaps_synced.ovs_seqno != ovsdb_idl_get_seqno(ovs_idl)
+           || encaps_synced.sb_seqno != encaps_sb_seqno(ovnsb_idl)
+           || encaps_synced.br_int != br_int
+           || encaps_synced.this_chassis != this_chassis
+           || !sset_equals(&encaps_synced.transport_zones, transport_zones);
+}
+
+static void
+encaps_inputs_record(const struct ovsdb_idl *ovs_idl,
+                     const struct ovsdb_idl *ovnsb_idl,
+                     const struct ovsrec_bridge *br_int,
+                     const struct sbrec_chassis *this_chassis,
+                     const struct sset *transport_zones)
+{
+    encaps_synced.valid = true;
+    encaps_synced.ovs_seqno = ovsdb_idl_get_seqno(ovs_idl);
+    encaps_synced.sb_seqno = encaps_sb_seqno(ovnsb_idl);
+    encaps_synced.br_int = br_int;
+    encaps_synced.this_chassis = this_chassis;
+    sset_destroy(&encaps_synced.transport_zones);
+    sset_clone(&encaps_synced.transport_zones, transport_zones);
+}
+
 void
 encaps_register_ovs_idl(struct ovsdb_idl *ovs_idl)
 {
@@ -711,6 +766,8 @@ create_port_based_tunnels(struct tunnel_ctx *tc,
 void
 encaps_run(struct ovsdb_idl_txn *ovs_idl_txn,
            struct ovsdb_idl_txn *ovnsb_idl_txn,
+           const struct ovsdb_idl *ovs_idl,
+           const struct ovsdb_idl *ovnsb_idl,
            const struct ovsrec_bridge *br_int,
            const struct sbrec_chassis_table *chassis_table,
            const struct sbrec_chassis *this_chassis,
@@ -723,6 +780,13 @@ encaps_run(struct ovsdb_idl_txn *ovs_idl_txn,
         return;
     }
 
+    if (!encaps_inputs_changed(ovs_idl, ovnsb_idl, br_int, this_chassis,
+                               transport_zones)) {
+        return;
+    }
+    encaps_inputs_record(ovs_idl, ovnsb_idl, br_int, this_chassis,
+                         transport_zones);
+
     bool use_flow_based = is_flow_based_tunnels_enabled(ovs_table,
                                                         this_chassis);
     VLOG_DBG("Using %s tunnels for this chassis.",
@@ -867,8 +931,18 @@ encaps_cleanup(struct ovsdb_idl_txn *ovs_idl_txn,
     return !any_changes;
 }
 
+/* Forces the next encaps_run() to reconcile tunnels, e.g. because the OVS
+ * transaction carrying the previous changes failed and left the IDL, and so
+ * its seqno, untouched. */
+void
+encaps_invalidate(void)
+{
+    encaps_synced.valid = false;
+}
+
 void
 encaps_destroy(void)
 {
     free(current_br_int_name);
+    sset_destroy(&encaps_synced.transport_zones);
 }
@@ -42,6 +42,8 @@ struct sset;
 void encaps_register_ovs_idl(struct ovsdb_idl *);
 void encaps_run(struct ovsdb_idl_txn *ovs_idl_txn,
                 struct ovsdb_idl_txn *ovnsb_idl_txn,
+                const struct ovsdb_idl *ovs_idl,
+                const struct ovsdb_idl *ovnsb_idl,
                 const struct ovsrec_bridge *br_int,
                 const struct sbrec_chassis_table *,
                 const struct sbrec_chassis *,
@@ -66,6 +68,7 @@ bool  encaps_tunnel_id_match(const char *tunnel_id, const char *chassis_id,
                              const char *remote_encap_ip,
                              const char *local_encap_ip);
 
+void encaps_invalidate(void);
 void encaps_destroy(void);
 
 #endif /* controller/encaps.h */
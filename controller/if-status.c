@@ -512,6 +512,7 @@ if_status_mgr_update(struct if_status_mgr *mgr,
 
     struct shash *bindings = &binding_data->bindings;
     struct hmapx_node *node;
+    long long int now = time_msec();
 
     /* Move all interfaces that have been confirmed without ovn-installed,
      * from OIF_REM_OLD_OVN_INST to OIF_MARK_UP.
@@ -538,7 +539,6 @@ if_status_mgr_update(struct if_status_mgr *mgr,
             if (!local_bindings_pb_chassis_is_set(bindings, iface->id,
                 chassis_rec)) {
                 if (!sb_readonly) {
-                    long long int now = time_msec();
                     const struct sbrec_port_binding *pb =
                         sbrec_port_binding_table_get_for_uuid(pb_table,
                                                               &iface->pb_uuid);
@@ -598,7 +598,6 @@ if_status_mgr_update(struct if_status_mgr *mgr,
             struct ovs_iface *iface = node->data;
             if (!local_bindings_pb_chassis_is_set(bindings, iface->id,
                 chassis_rec)) {
-                long long int now = time_msec();
                 const struct sbrec_port_binding *pb =
                     sbrec_port_binding_table_get_for_uuid(pb_table,
                                                           &iface->pb_uuid);
@@ -702,27 +701,33 @@ if_status_mgr_run(struct if_status_mgr *mgr,
 
     /* Move interfaces from state OIF_INSTALL_FLOWS to OIF_MARK_UP if a
      * notification has been received aabout their flows being installed
-     * in OVS.
+     * in OVS.  All interfaces claimed in the same iteration share one
+     * install seqno, so while a large batch is pending most runs have
+     * nothing acked and the scan over the whole batch can be skipped.
      */
-    HMAPX_FOR_EACH_SAFE (node, &mgr->ifaces_per_state[OIF_INSTALL_FLOWS]) {
-        struct ovs_iface *iface = node->data;
+    if (!vector_is_empty(&acked_seqnos->acked)) {
+        HMAPX_FOR_EACH_SAFE (node,
+                             &mgr->ifaces_per_state[OIF_INSTALL_FLOWS]) {
+            struct ovs_iface *iface = node->data;
 
-        if (!ofctrl_acked_seqnos_contains(acked_seqnos,
-                                          iface->install_seqno)) {
-            continue;
-        }
-        /* Wait for ovn-installed to be absent before moving to MARK_UP state.
-         * Most of the times ovn-installed is already absent and hence we will
-         * not have to wait.
-         * If there is no binding_data, we can't determine if ovn-installed is
-         * present or not; hence also go to the OIF_REM_OLD_OVN_INST state.
-         */
-        if (!binding_data ||
-            local_binding_is_ovn_installed(&binding_data->bindings,
-                                           iface->id)) {
-            ovs_iface_set_state(mgr, iface, OIF_REM_OLD_OVN_INST);
-        } else {
-            ovs_iface_set_state(mgr, iface, OIF_MARK_UP);
+            if (!ofctrl_acked_seqnos_contains(acked_seqnos,
+                                              iface->install_seqno)) {
+                continue;
+            }
+            /* Wait for ovn-installed to be absent before moving to MARK_UP
+             * state.  Most of the times ovn-installed is already absent and
+             * hence we will not have to wait.
+             * If there is no binding_data, we can't determine if
+             * ovn-installed is present or not; hence also go to the
+             * OIF_REM_OLD_OVN_INST state.
+             */
+            if (!binding_data ||
+                local_binding_is_ovn_installed(&binding_data->bindings,
+                                               iface->id)) {
+                ovs_iface_set_state(mgr, iface, OIF_REM_OLD_OVN_INST);
+            } else {
+                ovs_iface_set_state(mgr, iface, OIF_MARK_UP);
+            }
         }
     }
     ofctrl_acked_seqnos_destroy(acked_seqnos);
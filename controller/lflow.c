@@ -18,6 +18,7 @@
 #include "lflow.h"
 #include "coverage.h"
 #include "ha-chassis.h"
+#include "hash.h"
 #include "lb.h"
 #include "lflow-cache.h"
 #include "local_data.h"
@@ -40,11 +41,13 @@
 #include "physical.h"
 #include "simap.h"
 #include "sset.h"
+#include "svec.h"
 
 VLOG_DEFINE_THIS_MODULE(lflow);
 
 COVERAGE_DEFINE(lflow_run);
 COVERAGE_DEFINE(consider_logical_flow);
+COVERAGE_DEFINE(consider_port_sec_flows);
 
 /* Symbol table. */
 
@@ -107,10 +110,106 @@ consider_lb_hairpin_flows(const struct ovn_controller_lb *lb,
 
 static void add_port_sec_flows(const struct shash *binding_lports,
                                const struct sbrec_chassis *,
-                               struct ovn_desired_flow_table *);
+                               struct ovn_desired_flow_table *,
+                               struct hmap *port_sec_cache);
 static void consider_port_sec_flows(const struct sbrec_port_binding *pb,
                                     struct ovn_desired_flow_table *);
 
+/* Node in lflow_ctx_out->port_sec_cache.  Keeps a copy of the inputs the
+ * port security flows of a port binding were built from. */
+struct port_sec_cache_node {
+    struct hmap_node hmap_node; /* Hashed by port binding uuid. */
+    struct uuid pb_uuid;
+    uint32_t flows_hash;        /* port_sec_flows_hash() of the inputs. */
+    struct svec port_security;
+    int64_t tunnel_key;
+    int64_t dp_tunnel_key;
+};
+
+static uint32_t
+port_sec_flows_hash(const struct sbrec_port_binding *pb)
+{
+    uint32_t hash = hash_add(pb->tunnel_key, pb->datapath->tunnel_key);
+    for (size_t i = 0; i < pb->n_port_security; i++) {
+        hash = hash_string(pb->port_security[i], hash);
+    }
+    return hash_finish(hash, pb->n_port_security);
+}
+
+/* Returns true if 'pb' still has the port security inputs that 'psc' was
+ * built from.  The hash is only a fast pre-check, the inputs themselves are
+ * compared so that a collision can't keep stale flows installed. */
+static bool
+port_sec_cache_node_matches(const struct port_sec_cache_node *psc,
+                            const struct sbrec_port_binding *pb)
+{
+    if (psc->flows_hash != port_sec_flows_hash(pb)
+        || psc->tunnel_key != pb->tunnel_key
+        || psc->dp_tunnel_key != pb->datapath->tunnel_key
+        || psc->port_security.n != pb->n_port_security) {
+        return false;
+    }
+    for (size_t i = 0; i < pb->n_port_security; i++) {
+        if (strcmp(psc->port_security.names[i], pb->port_security[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void
+port_sec_cache_node_destroy(struct port_sec_cache_node *psc)
+{
+    svec_destroy(&psc->port_security);
+    free(psc);
+}
+
+static struct port_sec_cache_node *
+port_sec_cache_find(const struct hmap *port_sec_cache,
+                    const struct uuid *pb_uuid)
+{
+    struct port_sec_cache_node *psc;
+    HMAP_FOR_EACH_WITH_HASH (psc, hmap_node, uuid_hash(pb_uuid),
+                             port_sec_cache) {
+        if (uuid_equals(&psc->pb_uuid, pb_uuid)) {
+            return psc;
+        }
+    }
+    return NULL;
+}
+
+static void
+port_sec_cache_add(struct hmap *port_sec_cache,
+                   const struct sbrec_port_binding *pb)
+{
+    struct port_sec_cache_node *psc = xmalloc(sizeof *psc);
+    psc->pb_uuid = pb->header_.uuid;
+    psc->flows_hash = port_sec_flows_hash(pb);
+    svec_init(&psc->port_security);
+    for (size_t i = 0; i < pb->n_port_security; i++) {
+        svec_add(&psc->port_security, pb->port_security[i]);
+    }
+    psc->tunnel_key = pb->tunnel_key;
+    psc->dp_tunnel_key = pb->datapath->tunnel_key;
+    hmap_insert(port_sec_cache, &psc->hmap_node, uuid_hash(&psc->pb_uuid));
+}
+
+static void
+lflow_port_sec_cache_clear(struct hmap *port_sec_cache)
+{
+    struct port_sec_cache_node *psc;
+    HMAP_FOR_EACH_POP (psc, hmap_node, port_sec_cache) {
+        port_sec_cache_node_destroy(psc);
+    }
+}
+
+void
+lflow_port_sec_cache_destroy(struct hmap *port_sec_cache)
+{
+    lflow_port_sec_cache_clear(port_sec_cache);
+    hmap_destroy(port_sec_cache);
+}
+
 static bool
 lookup_port_cb(const void *aux_, const char *port_name, unsigned int *portp)
 {
@@ -720,7 +819,8 @@ lflow_handle_addr_set_update(const char *as_name,
     bool ret = true;
     struct object_to_resources_list_node *resource_list_node;
     RESOURCE_FOR_EACH_OBJ (resource_list_node, resource_node) {
-        const struct uuid *obj_uuid = &resource_list_node->obj_uuid;
+        const struct uuid *obj_uuid =
+            &resource_list_node->object_node->obj_uuid;
         if (uuidset_find(l_ctx_out->objs_processed, obj_uuid)) {
             VLOG_DBG("lflow "UUID_FMT"has been processed, skip.",
                      UUID_ARGS(obj_uuid));
@@ -2037,7 +2137,7 @@ lflow_run(struct lflow_ctx_in *l_ctx_in, struct lflow_ctx_out *l_ctx_out)
                   l_ctx_in->sbrec_port_binding_by_key,
                   l_ctx_in->localnet_learn_fdb);
     add_port_sec_flows(l_ctx_in->binding_lports, l_ctx_in->chassis,
-                       l_ctx_out->flow_table);
+                       l_ctx_out->flow_table, l_ctx_out->port_sec_cache);
 }
 
 /* Should be called at every ovn-controller iteration before IDL tracked
@@ -2188,16 +2288,29 @@ lflow_handle_flows_for_lport(const struct sbrec_port_binding *pb,
      * the logical flow table (l_ctx_out->flow_table) only for port
      * security flows.  Later if new flows are added using the
      * port binding'uuid', then this function should handle it properly.
-     */
-    ofctrl_remove_flows(l_ctx_out->flow_table, &pb->header_.uuid);
+     *
+     * The flows only depend on the port security addresses and on the
+     * port and datapath keys, so they are left alone if none of these
+     * changed, which is the common case for updates of other columns. */
+    bool want_port_sec = !deleted && pb->n_port_security &&
+                         shash_find(l_ctx_in->binding_lports,
+                                    pb->logical_port);
+    struct port_sec_cache_node *psc =
+        port_sec_cache_find(l_ctx_out->port_sec_cache, &pb->header_.uuid);
+    if (!want_port_sec || !psc || !port_sec_cache_node_matches(psc, pb)) {
+        ofctrl_remove_flows(l_ctx_out->flow_table, &pb->header_.uuid);
+        if (psc) {
+            hmap_remove(l_ctx_out->port_sec_cache, &psc->hmap_node);
+            port_sec_cache_node_destroy(psc);
+        }
+        if (want_port_sec) {
+            consider_port_sec_flows(pb, l_ctx_out->flow_table);
+            port_sec_cache_add(l_ctx_out->port_sec_cache, pb);
+        }
+    }
     if (deleted) {
         return true;
     }
-
-    if (pb->n_port_security && shash_find(l_ctx_in->binding_lports,
-                                          pb->logical_port)) {
-        consider_port_sec_flows(pb, l_ctx_out->flow_table);
-    }
     if (l_ctx_in->localnet_learn_fdb_changed && l_ctx_in->localnet_learn_fdb) {
         const struct sbrec_fdb *fdb;
         SBREC_FDB_TABLE_FOR_EACH (fdb, l_ctx_in->fdb_table) {
@@ -2344,8 +2457,12 @@ lflow_handle_changed_fdbs(struct lflow_ctx_in *l_ctx_in,
 static void
 add_port_sec_flows(const struct shash *binding_lports,
                    const struct sbrec_chassis *chassis,
-                   struct ovn_desired_flow_table *flow_table)
+                   struct ovn_desired_flow_table *flow_table,
+                   struct hmap *port_sec_cache)
 {
+    /* Called on full recompute, after the flow table has been cleared. */
+    lflow_port_sec_cache_clear(port_sec_cache);
+
     const struct shash_node *node;
     SHASH_FOR_EACH (node, binding_lports) {
         const struct binding_lport *b_lport = node->data;
@@ -2354,6 +2471,9 @@ add_port_sec_flows(const struct shash *binding_lports,
         }
 
         consider_port_sec_flows(b_lport->pb, flow_table);
+        if (b_lport->pb->n_port_security) {
+            port_sec_cache_add(port_sec_cache, b_lport->pb);
+        }
     }
 }
 
@@ -3349,6 +3469,8 @@ consider_port_sec_flows(const struct sbrec_port_binding *pb,
         return;
     }
 
+    COVERAGE_INC(consider_port_sec_flows);
+
     struct match match = MATCH_CATCHALL_INITIALIZER;
     uint64_t stub[1024 / 8];
     struct ofpbuf ofpacts = OFPBUF_STUB_INITIALIZER(stub);
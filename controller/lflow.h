@@ -154,6 +154,9 @@ struct lflow_ctx_out {
     struct lflow_cache *lflow_cache;
     struct conj_ids *conj_ids;
     struct uuidset *objs_processed;
+    /* Port bindings whose port security flows are installed.  Contains
+     * struct port_sec_cache_node. */
+    struct hmap *port_sec_cache;
 };
 
 void lflow_init(void);
@@ -192,6 +195,7 @@ bool lflow_handle_changed_lbs(struct lflow_ctx_in *l_ctx_in,
                               const struct uuidset *new_lbs);
 bool lflow_handle_changed_fdbs(struct lflow_ctx_in *, struct lflow_ctx_out *);
 void lflow_destroy(void);
+void lflow_port_sec_cache_destroy(struct hmap *port_sec_cache);
 
 bool lflow_add_flows_for_datapath(const struct sbrec_datapath_binding *,
                                   struct lflow_ctx_in *,
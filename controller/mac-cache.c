@@ -56,7 +56,8 @@ static void
 mac_cache_threshold_remove(struct hmap *thresholds,
                            struct mac_cache_threshold *threshold);
 static void
-mac_cache_update_req_delay(struct hmap *thresholds, uint64_t *req_delay);
+mac_cache_update_req_delay(struct hmap *thresholds,
+                           const struct hmap *entries, uint64_t *req_delay);
 
 static struct buffered_packets *
 buffered_packets_find(struct buffered_packets_ctx *ctx,
@@ -443,7 +444,8 @@ mac_binding_stats_run(
         }
     }
 
-    mac_cache_update_req_delay(&cache_data->thresholds, req_delay);
+    mac_cache_update_req_delay(&cache_data->thresholds,
+                               &cache_data->mac_bindings, req_delay);
     if (*req_delay) {
         VLOG_DBG("MAC binding statistics dalay: %"PRIu64, *req_delay);
     }
@@ -541,7 +543,8 @@ fdb_stats_run(struct rconn *swconn OVS_UNUSED,
         }
     }
 
-    mac_cache_update_req_delay(&cache_data->thresholds, req_delay);
+    mac_cache_update_req_delay(&cache_data->thresholds, &cache_data->fdbs,
+                               req_delay);
     if (*req_delay) {
         VLOG_DBG("FDB entry statistics dalay: %"PRIu64, *req_delay);
     }
@@ -762,9 +765,18 @@ mac_cache_threshold_remove(struct hmap *thresholds,
     free(threshold);
 }
 
+/* Sets 'req_delay' to the shortest dump period of the datapaths with aging
+ * enabled, or to 0 to stop the statistics requests if there are no local
+ * 'entries' whose usage should be tracked. */
 static void
-mac_cache_update_req_delay(struct hmap *thresholds, uint64_t *req_delay)
+mac_cache_update_req_delay(struct hmap *thresholds,
+                           const struct hmap *entries, uint64_t *req_delay)
 {
+    if (hmap_is_empty(entries)) {
+        *req_delay = 0;
+        return;
+    }
+
     struct mac_cache_threshold *threshold;
 
     uint64_t dump_period = UINT64_MAX;
@@ -940,7 +952,8 @@ mac_binding_probe_stats_run(
         destroy_lport_addresses(&laddr);
     }
 
-    mac_cache_update_req_delay(&cache_data->thresholds, req_delay);
+    mac_cache_update_req_delay(&cache_data->thresholds,
+                               &cache_data->mac_bindings, req_delay);
     if (*req_delay) {
         VLOG_DBG("MAC probe binding statistics delay: %"PRIu64, *req_delay);
     }
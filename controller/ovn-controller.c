@@ -3733,6 +3733,10 @@ struct ed_type_lflow_output {
     /* conjunciton ID usage information of lflows */
     struct conj_ids conj_ids;
 
+    /* Port bindings whose port security flows are installed, see
+     * lflow_handle_flows_for_lport(). */
+    struct hmap port_sec_cache;
+
     /* objects (lflows) processed in the current engine execution.
      * Cleared by en_lflow_output_clear_tracked_data before each engine
      * execution. */
@@ -3906,6 +3910,7 @@ init_lflow_ctx(struct engine_node *node,
     l_ctx_out->lflow_deps_mgr = &fo->lflow_deps_mgr;
     l_ctx_out->conj_ids = &fo->conj_ids;
     l_ctx_out->objs_processed = &fo->objs_processed;
+    l_ctx_out->port_sec_cache = &fo->port_sec_cache;
     l_ctx_out->lflow_cache = fo->pd.lflow_cache;
 }
 
@@ -3920,6 +3925,7 @@ en_lflow_output_init(struct engine_node *node OVS_UNUSED,
     objdep_mgr_init(&data->lflow_deps_mgr);
     lflow_conj_ids_init(&data->conj_ids);
     uuidset_init(&data->objs_processed);
+    hmap_init(&data->port_sec_cache);
     nd_ra_opts_init(&data->nd_ra_opts);
     controller_event_opts_init(&data->controller_event_opts);
     flow_collector_ids_init(&data->collector_ids);
@@ -3943,6 +3949,7 @@ en_lflow_output_cleanup(void *data)
     objdep_mgr_destroy(&flow_output_data->lflow_deps_mgr);
     lflow_conj_ids_destroy(&flow_output_data->conj_ids);
     uuidset_destroy(&flow_output_data->objs_processed);
+    lflow_port_sec_cache_destroy(&flow_output_data->port_sec_cache);
     lflow_cache_destroy(flow_output_data->pd.lflow_cache);
     nd_ra_opts_destroy(&flow_output_data->nd_ra_opts);
     controller_event_opts_destroy(&flow_output_data->controller_event_opts);
@@ -7456,6 +7463,10 @@ main(int argc, char *argv[])
             lflow_cache_get_memory_usage(ctrl_engine_ctx.lflow_cache, &usage);
             ofctrl_get_memory_usage(&usage);
             if_status_mgr_get_memory_usage(if_mgr, &usage);
+            objdep_mgr_get_memory_usage(&lflow_output_data->lflow_deps_mgr,
+                                        "lflow_deps", &usage);
+            objdep_mgr_get_memory_usage(&lb_data->deps_mgr, "lb_deps",
+                                        &usage);
             local_datapath_memory_usage(&usage);
             ovsdb_idl_get_memory_usage(ovnsb_idl_loop.idl, &usage);
             ovsdb_idl_get_memory_usage(ovs_idl_loop.idl, &usage);
@@ -7629,7 +7640,8 @@ main(int argc, char *argv[])
                 const struct sbrec_sb_global *sbg =
                     sbrec_sb_global_first(ovnsb_idl_loop.idl);
                 if (chassis && sbg && ovs_feature_set_discovered()) {
-                    encaps_run(ovs_idl_txn, ovnsb_idl_txn, br_int,
+                    encaps_run(ovs_idl_txn, ovnsb_idl_txn,
+                               ovs_idl_loop.idl, ovnsb_idl_loop.idl, br_int,
                                sbrec_chassis_table_get(ovnsb_idl_loop.idl),
                                chassis,
                                sbg,
@@ -8000,6 +8012,7 @@ main(int argc, char *argv[])
                     &vif_plug_deleted_iface_ids);
             vif_plug_clear_changed(
                     &vif_plug_changed_iface_ids);
+            encaps_invalidate();
         } else if (ovs_txn_status == 1) {
             /* The transaction committed successfully
              * (or it did not change anything in the database). */
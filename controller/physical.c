@@ -54,6 +54,7 @@
 #include "socket-util.h"
 #include "sset.h"
 #include "util.h"
+#include "vec.h"
 #include "vswitch-idl.h"
 #include "hmapx.h"
 #include "neighbor-of.h"
@@ -3907,11 +3908,18 @@ physical_run(struct physical_ctx *p_ctx,
                                  &ofpacts, flow_table);
 
     /* Set up flows in table 0 for physical-to-logical translation and in table
-     * 64 for logical-to-physical translation. */
+     * 64 for logical-to-physical translation.  Remember the vtep ports for
+     * the ramp switch flows below, so that the port binding table is walked
+     * only once. */
+    struct vector vtep_lports =
+        VECTOR_EMPTY_INITIALIZER(const struct sbrec_port_binding *);
     const struct sbrec_port_binding *binding;
     SBREC_PORT_BINDING_TABLE_FOR_EACH (binding, p_ctx->port_binding_table) {
         consider_port_binding(p_ctx, binding, get_lport_type(binding),
                               flow_table, &ofpacts);
+        if (!strcmp(binding->type, "vtep")) {
+            vector_push(&vtep_lports, &binding);
+        }
     }
 
     /* Default flow for CT_ZONE_LOOKUP Table. */
@@ -3998,12 +4006,7 @@ physical_run(struct physical_ctx *p_ctx,
             continue;
         }
 
-        SBREC_PORT_BINDING_TABLE_FOR_EACH (binding,
-                                           p_ctx->port_binding_table) {
-            if (strcmp(binding->type, "vtep")) {
-                continue;
-            }
-
+        VECTOR_FOR_EACH (&vtep_lports, binding) {
             if (!binding->chassis ||
                 !encaps_tunnel_id_match(tun->chassis_id,
                                         binding->chassis->name, NULL, NULL)) {
@@ -4032,6 +4035,7 @@ physical_run(struct physical_ctx *p_ctx,
                             &match, &ofpacts, hc_uuid);
         }
     }
+    vector_destroy(&vtep_lports);
 
     /* Table 0, priority 0.
      * ======================
@@ -323,6 +323,8 @@ static void sync_svc_monitors(
     struct ovsdb_idl_index *sbrec_port_binding_by_name,
     const struct sbrec_chassis *our_chassis)
     OVS_REQUIRES(pinctrl_mutex);
+static void update_svc_monitors_status(struct ovsdb_idl_txn *ovnsb_idl_txn)
+    OVS_REQUIRES(pinctrl_mutex);
 static void svc_monitors_run(struct rconn *swconn,
                              long long int *svc_monitors_next_run_time)
     OVS_REQUIRES(pinctrl_mutex);
@@ -4105,6 +4107,10 @@ pinctrl_update(const struct ovsdb_idl *idl)
         notify_pinctrl_handler();
     }
 
+    svc_monitors_sb_seqno = MAX(sbrec_service_monitor_get_seqno(idl),
+                                MAX(sbrec_port_binding_get_seqno(idl),
+                                    sbrec_datapath_binding_get_seqno(idl)));
+
 
     ovs_mutex_unlock(&pinctrl_mutex);
 }
@@ -6971,16 +6977,59 @@ struct svc_monitor {
     ovs_be16 icmp_seq_no;
 
     bool delete;
+
+    /* In 'svc_monitors_status_dirty' while 'status' still has to be written
+     * to 'sb_svc_mon'. */
+    struct ovs_list status_node;
 };
 
 static struct hmap svc_monitors_map;
 static struct ovs_list svc_monitors;
+static struct ovs_list svc_monitors_status_dirty;
+
+/* sync_svc_monitors() only depends on the SB Service_Monitor, Port_Binding
+ * and Datapath_Binding tables and on our chassis record.  The highest change
+ * seqno of those tables is recorded by pinctrl_update() and compared with
+ * the one of the last full sync, so that the scan of all service monitors is
+ * skipped while none of them changed.  Protected by pinctrl_mutex. */
+static unsigned int svc_monitors_sb_seqno;
+static unsigned int svc_monitors_synced_seqno;
+static const struct sbrec_chassis *svc_monitors_chassis;
+static bool svc_monitors_synced;
 
 static void
 init_svc_monitors(void)
 {
     hmap_init(&svc_monitors_map);
     ovs_list_init(&svc_monitors);
+    ovs_list_init(&svc_monitors_status_dirty);
+}
+
+static void
+svc_monitor_set_status_dirty(struct svc_monitor *svc_mon, bool dirty)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    bool is_dirty = !ovs_list_is_empty(&svc_mon->status_node);
+    if (dirty && !is_dirty) {
+        ovs_list_push_back(&svc_monitors_status_dirty, &svc_mon->status_node);
+    } else if (!dirty && is_dirty) {
+        ovs_list_remove(&svc_mon->status_node);
+        ovs_list_init(&svc_mon->status_node);
+    }
+}
+
+static const char *
+svc_monitor_status_to_string(const struct svc_monitor *svc_mon)
+{
+    switch (svc_mon->status) {
+    case SVC_MON_ST_ONLINE:
+        return "online";
+    case SVC_MON_ST_OFFLINE:
+        return "offline";
+    case SVC_MON_ST_UNKNOWN:
+    default:
+        return NULL;
+    }
 }
 
 static void
@@ -7029,6 +7078,13 @@ sync_svc_monitors(struct ovsdb_idl_txn *ovnsb_idl_txn,
     bool changed = false;
     struct svc_monitor *svc_mon;
 
+    if (svc_monitors_synced
+        && svc_monitors_synced_seqno == svc_monitors_sb_seqno
+        && svc_monitors_chassis == our_chassis) {
+        update_svc_monitors_status(ovnsb_idl_txn);
+        return;
+    }
+
     LIST_FOR_EACH (svc_mon, list_node, &svc_monitors) {
         svc_mon->delete = true;
     }
@@ -7184,6 +7240,7 @@ sync_svc_monitors(struct ovsdb_idl_txn *ovnsb_idl_txn,
                 smap_get_int(&svc_mon->options, "failure_count", 1);
             svc_mon->n_success = 0;
             svc_mon->n_failures = 0;
+            ovs_list_init(&svc_mon->status_node);
 
             eth_addr_from_string(sb_svc_mon->src_mac, &svc_mon->src_mac);
 
@@ -7194,6 +7251,13 @@ sync_svc_monitors(struct ovsdb_idl_txn *ovnsb_idl_txn,
 
         svc_mon->sb_svc_mon = sb_svc_mon;
         svc_mon->ea = ea;
+
+        /* The row may be new, or its status may have been changed by
+         * someone else. */
+        const char *status = svc_monitor_status_to_string(svc_mon);
+        if (status && !nullable_string_is_equal(status, sb_svc_mon->status)) {
+            svc_monitor_set_status_dirty(svc_mon, true);
+        }
         if (!smap_equal(&svc_mon->options, &sb_svc_mon->options)) {
             smap_destroy(&svc_mon->options);
             smap_clone(&svc_mon->options, &sb_svc_mon->options);
@@ -7215,29 +7279,48 @@ sync_svc_monitors(struct ovsdb_idl_txn *ovnsb_idl_txn,
         if (svc_mon->delete) {
             hmap_remove(&svc_monitors_map, &svc_mon->hmap_node);
             ovs_list_remove(&svc_mon->list_node);
+            svc_monitor_set_status_dirty(svc_mon, false);
             smap_destroy(&svc_mon->options);
             free(svc_mon);
             changed = true;
-        } else if (ovnsb_idl_txn) {
-            /* Update the status of the service monitor. */
-            if (svc_mon->status != SVC_MON_ST_UNKNOWN) {
-                if (svc_mon->status == SVC_MON_ST_ONLINE) {
-                    sbrec_service_monitor_set_status(svc_mon->sb_svc_mon,
-                                                     "online");
-                } else {
-                    sbrec_service_monitor_set_status(svc_mon->sb_svc_mon,
-                                                     "offline");
-                }
-            }
         }
     }
 
+    svc_monitors_synced = true;
+    svc_monitors_synced_seqno = svc_monitors_sb_seqno;
+    svc_monitors_chassis = our_chassis;
+
+    update_svc_monitors_status(ovnsb_idl_txn);
+
     if (changed) {
         notify_pinctrl_handler();
     }
 
 }
 
+/* Writes the status of the service monitors whose status changed to SB.  A
+ * monitor stays dirty until its row shows the new status, so that the write
+ * is retried if the transaction fails. */
+static void
+update_svc_monitors_status(struct ovsdb_idl_txn *ovnsb_idl_txn)
+    OVS_REQUIRES(pinctrl_mutex)
+{
+    if (!ovnsb_idl_txn) {
+        return;
+    }
+
+    struct svc_monitor *svc_mon;
+    LIST_FOR_EACH_SAFE (svc_mon, status_node, &svc_monitors_status_dirty) {
+        const char *status = svc_monitor_status_to_string(svc_mon);
+        if (!status
+            || nullable_string_is_equal(status, svc_mon->sb_svc_mon->status)) {
+            svc_monitor_set_status_dirty(svc_mon, false);
+        } else {
+            sbrec_service_monitor_set_status(svc_mon->sb_svc_mon, status);
+        }
+    }
+}
+
 enum bfd_state {
     BFD_STATE_ADMIN_DOWN,
     BFD_STATE_DOWN,
@@ -8239,6 +8322,7 @@ svc_monitors_run(struct rconn *swconn,
 
         if (old_status != svc_mon->status) {
             /* Notify the main thread to update the status in the SB DB. */
+            svc_monitor_set_status_dirty(svc_mon, true);
             notify_pinctrl_main();
         }
     }
@@ -8752,6 +8836,11 @@ pinctrl_split_buf_action_handler(struct rconn *swconn, struct dp_packet *pkt,
 
 #define MAX_FDB_ENTRIES             1000
 
+/* An SB FDB entry that already points to the learned port is not rewritten
+ * if its timestamp is younger than a quarter of the datapath's aging
+ * threshold, or than this many msec if the datapath has no threshold. */
+#define FDB_FRESH_MSEC              5000
+
 static struct hmap put_fdbs;
 
 /* MAC learning (fdb) related functions.  Runs within the main
@@ -8786,6 +8875,28 @@ fdb_lookup(struct ovsdb_idl_index *sbrec_fdb_by_dp_key_mac, uint32_t dp_key,
     return retval;
 }
 
+static bool
+fdb_is_fresh(struct ovsdb_idl_index *sbrec_datapath_binding_by_key,
+             const struct sbrec_fdb *sb_fdb)
+{
+    if (!pinctrl.fdb_can_timestamp) {
+        return true;
+    }
+
+    long long int fresh_ms = FDB_FRESH_MSEC;
+    const struct sbrec_datapath_binding *dp =
+        datapath_lookup_by_key(sbrec_datapath_binding_by_key, sb_fdb->dp_key);
+    if (dp) {
+        uint64_t threshold =
+            smap_get_uint(&dp->external_ids, "fdb_age_threshold", 0);
+        if (threshold) {
+            fresh_ms = threshold * 1000 / 4;
+        }
+    }
+
+    return time_wall_msec() - sb_fdb->timestamp < fresh_ms;
+}
+
 static void
 run_put_fdb(struct ovsdb_idl_txn *ovnsb_idl_txn,
             struct ovsdb_idl_index *sbrec_fdb_by_dp_key_mac,
@@ -8809,6 +8920,14 @@ run_put_fdb(struct ovsdb_idl_txn *ovnsb_idl_txn,
         sb_fdb = sbrec_fdb_insert(ovnsb_idl_txn);
         sbrec_fdb_set_dp_key(sb_fdb, fdb->data.dp_key);
         sbrec_fdb_set_mac(sb_fdb, mac_string);
+    } else if (sb_fdb->port_key == fdb->data.port_key &&
+               fdb_is_fresh(sbrec_datapath_binding_by_key, sb_fdb)) {
+        /* The entry was learned by another chassis (or by us) a moment ago,
+         * e.g. during a failover where many chassis learn the same MACs.
+         * Rewriting it would only bump the timestamp and conflict with the
+         * other writers. */
+        fdb_remove(&put_fdbs, fdb);
+        return;
     } else {
         new_entry_pb = lport_lookup_by_key(
             sbrec_datapath_binding_by_key, sbrec_port_binding_by_key,
@@ -56,14 +56,21 @@ struct stats_node {
     int64_t next_request_timestamp;
     /* Request delay in ms. */
     uint64_t request_delay;
-    /* Vector of processed statistics. */
+    /* Vector of processed statistics, handed over from the statctrl thread
+     * to the main thread.  Protected by mutex. */
     struct vector stats;
+    /* Statistics being decoded from a reply.  Only used by the statctrl
+     * thread, so that replies are parsed without holding the mutex. */
+    struct vector decoded;
+    /* Statistics being processed.  Only used by the main thread, swapped
+     * with 'stats' so that they are processed without holding the mutex. */
+    struct vector processing;
     /* Function to process the response and store it in the list.
-     * This function runs in statctrl thread locked behind mutex. */
+     * This function runs in statctrl thread. */
     void (*process_flow_stats)(struct vector *stats,
                                struct ofputil_flow_stats *ofp_stats);
     /* Function to process the parsed stats.
-     * This function runs in main thread locked behind mutex. */
+     * This function runs in main thread. */
     void (*run)(struct rconn *swconn,
                 struct ovsdb_idl_index *sbrec_port_binding_by_name,
                 struct vector *stats,
@@ -80,6 +87,8 @@ struct stats_node {
             .next_request_timestamp = INT64_MAX,                           \
             .request_delay = 0,                                            \
             .stats = VECTOR_EMPTY_INITIALIZER(STAT_TYPE),                  \
+            .decoded = VECTOR_EMPTY_INITIALIZER(STAT_TYPE),                \
+            .processing = VECTOR_EMPTY_INITIALIZER(STAT_TYPE),             \
             .process_flow_stats = PROCESS,                                 \
             .run = RUN,                                                    \
             .name = OVS_STRINGIZE(stats_##NAME),                 \
@@ -111,8 +120,7 @@ static void statctrl_handle_rconn_msg(struct rconn *swconn,
 static enum stat_type statctrl_get_stat_type(struct statctrl_ctx *ctx,
                                              const struct ofp_header *oh);
 static void statctrl_decode_statistics_reply(struct stats_node *node,
-                                             struct ofpbuf *msg)
-    OVS_REQUIRES(mutex);
+                                             struct ofpbuf *msg);
 static void statctrl_send_request(struct rconn *swconn,
                                   struct statctrl_ctx *ctx)
     OVS_REQUIRES(mutex);
@@ -189,26 +197,46 @@ statctrl_run(struct ovsdb_idl_txn *ovnsb_idl_txn,
 
     bool schedule_updated = false;
     long long now = time_msec();
+    uint64_t request_delays[STATS_MAX];
 
+    /* Take the collected statistics over, so that the statctrl thread can
+     * keep on decoding replies while they are processed. */
     ovs_mutex_lock(&mutex);
     statctrl_ctx.new_main_seq = seq_read(statctrl_ctx.main_seq);
     for (size_t i = 0; i < STATS_MAX; i++) {
         struct stats_node *node = &statctrl_ctx.nodes[i];
-        uint64_t prev_delay = node->request_delay;
+        struct vector tmp = node->processing;
+
+        node->processing = node->stats;
+        node->stats = tmp;
+        request_delays[i] = node->request_delay;
+    }
+    ovs_mutex_unlock(&mutex);
+
+    for (size_t i = 0; i < STATS_MAX; i++) {
+        struct stats_node *node = &statctrl_ctx.nodes[i];
 
         stopwatch_start(node->name, time_msec());
         node->run(statctrl_ctx.swconn,
-                  sbrec_port_binding_by_name, &node->stats,
-                  &node->request_delay, node_data[i]);
-        vector_clear(&node->stats);
-        if (vector_capacity(&node->stats) >= STATS_VEC_CAPACITY_THRESHOLD) {
+                  sbrec_port_binding_by_name, &node->processing,
+                  &request_delays[i], node_data[i]);
+        vector_clear(&node->processing);
+        if (vector_capacity(&node->processing)
+            >= STATS_VEC_CAPACITY_THRESHOLD) {
             VLOG_DBG("The statistics vector for node '%s' capacity "
                      "(%"PRIuSIZE") is over threshold.", node->name,
-                     vector_capacity(&node->stats));
-            vector_shrink_to_fit(&node->stats);
+                     vector_capacity(&node->processing));
+            vector_shrink_to_fit(&node->processing);
         }
         stopwatch_stop(node->name, time_msec());
+    }
+
+    ovs_mutex_lock(&mutex);
+    for (size_t i = 0; i < STATS_MAX; i++) {
+        struct stats_node *node = &statctrl_ctx.nodes[i];
+        uint64_t prev_delay = node->request_delay;
 
+        node->request_delay = request_delays[i];
         schedule_updated |=
                 statctrl_update_next_request_timestamp(node, now, prev_delay);
     }
@@ -261,6 +289,8 @@ statctrl_destroy(void)
     for (size_t i = 0; i < STATS_MAX; i++) {
         struct stats_node *node = &statctrl_ctx.nodes[i];
         vector_destroy(&node->stats);
+        vector_destroy(&node->decoded);
+        vector_destroy(&node->processing);
     }
 }
 
@@ -325,9 +355,7 @@ statctrl_handle_rconn_msg(struct rconn *swconn, struct statctrl_ctx *ctx,
             return;
         }
 
-        ovs_mutex_lock(&mutex);
         statctrl_decode_statistics_reply(&ctx->nodes[stype], msg);
-        ovs_mutex_unlock(&mutex);
     } else {
         if (VLOG_IS_DBG_ENABLED()) {
 
@@ -354,7 +382,6 @@ statctrl_get_stat_type(struct statctrl_ctx *ctx, const struct ofp_header *oh)
 
 static void
 statctrl_decode_statistics_reply(struct stats_node *node, struct ofpbuf *msg)
-    OVS_REQUIRES(mutex)
 {
     struct ofpbuf ofpacts;
     ofpbuf_init(&ofpacts, 0);
@@ -370,10 +397,32 @@ statctrl_decode_statistics_reply(struct stats_node *node, struct ofpbuf *msg)
             break;
         }
 
-        node->process_flow_stats(&node->stats, &fs);
+        node->process_flow_stats(&node->decoded, &fs);
     }
 
     ofpbuf_uninit(&ofpacts);
+
+    if (vector_is_empty(&node->decoded)) {
+        return;
+    }
+
+    /* Only the hand-over of the compact records is done under the mutex. */
+    ovs_mutex_lock(&mutex);
+    if (vector_is_empty(&node->stats)) {
+        struct vector tmp = node->stats;
+
+        node->stats = node->decoded;
+        node->decoded = tmp;
+    } else {
+        vector_push_array(&node->stats, vector_get_array(&node->decoded),
+                          vector_len(&node->decoded));
+    }
+    ovs_mutex_unlock(&mutex);
+
+    vector_clear(&node->decoded);
+    if (vector_capacity(&node->decoded) >= STATS_VEC_CAPACITY_THRESHOLD) {
+        vector_shrink_to_fit(&node->decoded);
+    }
 }
 
 static void
@@ -264,6 +264,11 @@ struct expr_symbol {
     bool must_crossproduct;
     enum expr_write_scope rw; /* Bit map indicating in which nested contexts
                                * the symbol is writeable */
+
+    /* Annotated 'prereqs' and 'predicate', if precomputed by
+     * expr_symtab_compile(), otherwise NULL. */
+    struct expr *prereqs_expr;
+    struct expr *predicate_expr;
 };
 
 void expr_symbol_format(const struct expr_symbol *, struct ds *);
@@ -318,6 +323,7 @@ struct expr_symbol *expr_symtab_add_predicate(struct shash *symtab,
 struct expr_symbol *expr_symtab_add_ovn_field(struct shash *symtab,
                                               const char *name,
                                               enum ovn_field_id id);
+void expr_symtab_compile(struct shash *symtab);
 void expr_symtab_destroy(struct shash *symtab);
 
 /* Expression type. */
@@ -464,6 +470,22 @@ bool expr_evaluate(const struct expr *, const struct flow *uflow,
                    bool (*lookup_port)(const void *aux, const char *port_name,
                                        unsigned int *portp),
                    const void *aux);
+
+/* Compiled expressions, for evaluating an expression against many
+ * microflows. */
+struct expr_program;
+
+struct expr_program *expr_compile(
+    const struct expr *,
+    bool (*lookup_port)(const void *aux, const char *port_name,
+                        unsigned int *portp),
+    const void *aux);
+void expr_program_destroy(struct expr_program *);
+bool expr_program_evaluate(const struct expr_program *,
+                           const struct flow *uflow);
+void expr_program_evaluate_batch(const struct expr_program *,
+                                 const struct flow *flows, size_t n,
+                                 unsigned long *results);
 
 /* Converting expressions to OpenFlow flows. */
 
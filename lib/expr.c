@@ -1539,6 +1539,12 @@ expr_parse_string(const char *s, const struct shash *symtab,
     return expr;
 }
 
+static struct expr *parse_and_annotate_cached(const char *s,
+                                              struct expr *cached,
+                                              const struct shash *symtab,
+                                              struct sset *nesting,
+                                              char **errorp);
+
 /* Parses a field or subfield from 'lexer' into 'field', obtaining field names
  * from 'symtab'.  Returns true if successful, false if an error occurred.
  * Upon return, returns true if and only if lexer->error is NULL. */
@@ -1557,8 +1563,9 @@ expr_field_parse(struct lexer *lexer, const struct shash *symtab,
             if (symbol->prereqs) {
                 char *error;
                 struct sset nesting = SSET_INITIALIZER(&nesting);
-                struct expr *e = parse_and_annotate(symbol->prereqs, symtab,
-                                                    &nesting, &error);
+                struct expr *e = parse_and_annotate_cached(
+                    symbol->prereqs, symbol->prereqs_expr, symtab, &nesting,
+                    &error);
                 sset_destroy(&nesting);
                 if (error) {
                     lexer_error(lexer, "%s", error);
@@ -1815,6 +1822,8 @@ expr_symtab_destroy(struct shash *symtab)
         free(symbol->name);
         free(symbol->prereqs);
         free(symbol->predicate);
+        expr_destroy(symbol->prereqs_expr);
+        expr_destroy(symbol->predicate_expr);
         free(symbol);
     }
 }
@@ -1936,6 +1945,21 @@ parse_and_annotate(const char *s, const struct shash *symtab,
     return expr;
 }
 
+/* Same as parse_and_annotate(), except that if 'cached' is nonnull, it is
+ * taken to be the result of parse_and_annotate() on 's', precomputed by
+ * expr_symtab_compile(), and a copy of it is returned instead. */
+static struct expr *
+parse_and_annotate_cached(const char *s, struct expr *cached,
+                          const struct shash *symtab, struct sset *nesting,
+                          char **errorp)
+{
+    if (cached) {
+        *errorp = NULL;
+        return expr_clone(cached);
+    }
+    return parse_and_annotate(s, symtab, nesting, errorp);
+}
+
 static struct expr *
 expr_annotate_cmp(struct expr *expr, const struct shash *symtab,
                   bool append_prereqs, struct sset *nesting, char **errorp)
@@ -1951,7 +1975,9 @@ expr_annotate_cmp(struct expr *expr, const struct shash *symtab,
 
     struct expr *prereqs = NULL;
     if (append_prereqs && symbol->prereqs) {
-        prereqs = parse_and_annotate(symbol->prereqs, symtab, nesting, errorp);
+        prereqs = parse_and_annotate_cached(symbol->prereqs,
+                                            symbol->prereqs_expr,
+                                            symtab, nesting, errorp);
         if (!prereqs) {
             goto error;
         }
@@ -1964,8 +1990,9 @@ expr_annotate_cmp(struct expr *expr, const struct shash *symtab,
     } else if (symbol->predicate) {
         struct expr *predicate;
 
-        predicate = parse_and_annotate(symbol->predicate, symtab,
-                                       nesting, errorp);
+        predicate = parse_and_annotate_cached(symbol->predicate,
+                                              symbol->predicate_expr,
+                                              symtab, nesting, errorp);
         if (!predicate) {
             goto error;
         }
@@ -2000,7 +2027,9 @@ expr_append_prereqs(struct expr *expr, const struct expr_symbol *symbol,
     struct expr *prereqs = NULL;
 
     if (symbol->prereqs) {
-        prereqs = parse_and_annotate(symbol->prereqs, symtab, nesting, errorp);
+        prereqs = parse_and_annotate_cached(symbol->prereqs,
+                                            symbol->prereqs_expr,
+                                            symtab, nesting, errorp);
         if (!prereqs) {
             expr_destroy(expr);
             return NULL;
@@ -2111,6 +2140,55 @@ expr_annotate(struct expr *expr, const struct shash *symtab, char **errorp)
     return result;
 }
 
+/* Precomputes, for each symbol in 'symtab', the annotated expressions for its
+ * prerequisites and, for a predicate, its expansion, so that expr_annotate()
+ * and expr_field_parse() can copy them instead of parsing and annotating the
+ * same strings again every time the symbol is referenced.
+ *
+ * Call this after adding all of the symbols to 'symtab'.  Symbols added
+ * afterward still work, but their expansions are parsed on each use until
+ * this function is called again.  Symbols whose expansions fail to parse or
+ * annotate are also left to be handled, and reported, on use. */
+void
+expr_symtab_compile(struct shash *symtab)
+{
+    struct shash_node *node;
+
+    /* Drop any earlier results first, so that every expansion below is
+     * computed from the symbols' current definitions. */
+    SHASH_FOR_EACH (node, symtab) {
+        struct expr_symbol *symbol = node->data;
+
+        expr_destroy(symbol->prereqs_expr);
+        symbol->prereqs_expr = NULL;
+        expr_destroy(symbol->predicate_expr);
+        symbol->predicate_expr = NULL;
+    }
+
+    SHASH_FOR_EACH (node, symtab) {
+        struct expr_symbol *symbol = node->data;
+        struct sset nesting = SSET_INITIALIZER(&nesting);
+        char *error;
+
+        /* Expanding a symbol happens with the symbol itself in 'nesting'
+         * (see expr_annotate_cmp()), so do the same here to reject the same
+         * recursive definitions. */
+        sset_add(&nesting, symbol->name);
+        if (symbol->prereqs) {
+            symbol->prereqs_expr = parse_and_annotate(symbol->prereqs, symtab,
+                                                      &nesting, &error);
+            free(error);
+        }
+        if (symbol->predicate) {
+            symbol->predicate_expr = parse_and_annotate(symbol->predicate,
+                                                        symtab, &nesting,
+                                                        &error);
+            free(error);
+        }
+        sset_destroy(&nesting);
+    }
+}
+
 static struct expr *
 expr_simplify_eq(struct expr *expr)
 {
@@ -3665,8 +3743,9 @@ expr_evaluate_cmp(const struct expr *e, const struct flow *f,
  * and 'aux' auxiliary data to pass to it; see expr_to_matches() for more
  * details.
  *
- * This isn't particularly fast.  For performance-sensitive tasks, use
- * expr_to_matches() and the classifier. */
+ * This isn't particularly fast.  To evaluate an expression against many
+ * microflows, use expr_compile() and expr_program_evaluate_batch().  For
+ * performance-sensitive tasks, use expr_to_matches() and the classifier. */
 bool
 expr_evaluate(const struct expr *e, const struct flow *uflow,
               bool (*lookup_port)(const void *aux, const char *port_name,
@@ -3696,6 +3775,268 @@ expr_evaluate(const struct expr *e, const struct flow *uflow,
     }
 }
 
+/* Compiled expressions.
+ *
+ * expr_compile() lowers an expression tree into a flat program for a stack
+ * machine, in postfix order, with comparisons against port names already
+ * resolved to port numbers.  expr_program_evaluate_batch() then runs each
+ * instruction across a whole batch of microflows at once, keeping one bitmap
+ * of per-flow results per stack entry, so that AND and OR combine the
+ * results of up to 64 microflows per machine word instead of walking the
+ * tree once per microflow. */
+
+enum expr_insn_type {
+    EXPR_INSN_CMP,              /* Push result of comparing a field. */
+    EXPR_INSN_CONST,            /* Push a constant. */
+    EXPR_INSN_AND,              /* Pop 'n_args' results, push their AND. */
+    EXPR_INSN_OR,               /* Pop 'n_args' results, push their OR. */
+};
+
+struct expr_insn {
+    enum expr_insn_type type;
+    union {
+        /* EXPR_INSN_CMP. */
+        struct {
+            const struct mf_field *field;
+            enum expr_relop relop;
+            bool is_port;       /* Compare against 'port', not 'value'. */
+            unsigned int port;
+            union mf_value value;
+            union mf_value mask;
+        } cmp;
+
+        bool constant;          /* EXPR_INSN_CONST. */
+        size_t n_args;          /* EXPR_INSN_AND, EXPR_INSN_OR. */
+    };
+};
+
+struct expr_program {
+    struct expr_insn *insns;
+    size_t n_insns;
+    size_t allocated_insns;
+    size_t max_depth;           /* Maximum number of stack entries. */
+};
+
+static struct expr_insn *
+expr_program_add(struct expr_program *prog, enum expr_insn_type type)
+{
+    if (prog->n_insns >= prog->allocated_insns) {
+        prog->insns = x2nrealloc(prog->insns, &prog->allocated_insns,
+                                 sizeof *prog->insns);
+    }
+    struct expr_insn *insn = &prog->insns[prog->n_insns++];
+    memset(insn, 0, sizeof *insn);
+    insn->type = type;
+    return insn;
+}
+
+static void
+expr_program_add_const(struct expr_program *prog, bool constant)
+{
+    expr_program_add(prog, EXPR_INSN_CONST)->constant = constant;
+}
+
+/* Appends to 'prog' the instructions to evaluate 'e', whose result ends up
+ * in stack entry 'depth'. */
+static void
+expr_compile__(const struct expr *e, struct expr_program *prog, size_t depth,
+               bool (*lookup_port)(const void *aux, const char *port_name,
+                                   unsigned int *portp),
+               const void *aux)
+{
+    prog->max_depth = MAX(prog->max_depth, depth + 1);
+
+    switch (e->type) {
+    case EXPR_T_CMP: {
+        const struct expr_symbol *s = e->cmp.symbol;
+        const struct mf_field *field = s->field;
+        struct expr_insn *insn;
+
+        if (s->width) {
+            int n_bytes = field->n_bytes;
+
+            insn = expr_program_add(prog, EXPR_INSN_CMP);
+            memcpy(&insn->cmp.value,
+                   &e->cmp.value.u8[sizeof e->cmp.value - n_bytes], n_bytes);
+            memcpy(&insn->cmp.mask,
+                   &e->cmp.mask.u8[sizeof e->cmp.mask - n_bytes], n_bytes);
+        } else {
+            unsigned int port;
+            if (!lookup_port(aux, e->cmp.string, &port)) {
+                /* Same as expr_evaluate(). */
+                expr_program_add_const(prog, false);
+                break;
+            }
+            insn = expr_program_add(prog, EXPR_INSN_CMP);
+            insn->cmp.is_port = true;
+            insn->cmp.port = port;
+        }
+        insn->cmp.field = field;
+        insn->cmp.relop = e->cmp.relop;
+        break;
+    }
+
+    case EXPR_T_AND:
+    case EXPR_T_OR: {
+        const struct expr *sub;
+        size_t n_args = 0;
+
+        LIST_FOR_EACH (sub, node, &e->andor) {
+            expr_compile__(sub, prog, depth + n_args++, lookup_port, aux);
+        }
+        if (n_args == 0) {
+            expr_program_add_const(prog, e->type == EXPR_T_AND);
+        } else if (n_args > 1) {
+            expr_program_add(prog, (e->type == EXPR_T_AND
+                                    ? EXPR_INSN_AND
+                                    : EXPR_INSN_OR))->n_args = n_args;
+        }
+        break;
+    }
+
+    case EXPR_T_BOOLEAN:
+        expr_program_add_const(prog, e->boolean);
+        break;
+
+    case EXPR_T_CONDITION:
+        /* Same as expr_evaluate(). */
+        expr_program_add_const(prog, !e->cond.not);
+        break;
+
+    default:
+        OVS_NOT_REACHED();
+    }
+}
+
+/* Compiles 'e' into a program that evaluates to the same result as
+ * expr_evaluate() would, for any microflow.  Port names are looked up right
+ * away with 'lookup_port' and 'aux' (see expr_evaluate()), which need not
+ * remain valid afterward.
+ *
+ * The caller must eventually free the returned program with
+ * expr_program_destroy(). */
+struct expr_program *
+expr_compile(const struct expr *e,
+             bool (*lookup_port)(const void *aux, const char *port_name,
+                                 unsigned int *portp),
+             const void *aux)
+{
+    struct expr_program *prog = xzalloc(sizeof *prog);
+    expr_compile__(e, prog, 0, lookup_port, aux);
+    return prog;
+}
+
+void
+expr_program_destroy(struct expr_program *prog)
+{
+    if (prog) {
+        free(prog->insns);
+        free(prog);
+    }
+}
+
+static bool
+expr_insn_evaluate_cmp(const struct expr_insn *insn, const struct flow *f)
+{
+    const struct mf_field *field = insn->cmp.field;
+    int cmp;
+
+    if (!insn->cmp.is_port) {
+        union mf_value value;
+        mf_get_value(field, f, &value);
+        for (int i = 0; i < field->n_bytes; i++) {
+            value.b[i] &= insn->cmp.mask.b[i];
+        }
+        cmp = memcmp(&value, &insn->cmp.value, field->n_bytes);
+    } else {
+        struct mf_subfield sf = { .field = field, .ofs = 0,
+                                  .n_bits = field->n_bits };
+        uint64_t value = mf_get_subfield(&sf, f);
+        cmp = value < insn->cmp.port ? -1 : value > insn->cmp.port;
+    }
+    return expr_relop_test(insn->cmp.relop, cmp);
+}
+
+/* Evaluates 'prog' against each of the 'n' microflows in 'flows' and sets
+ * bit 'i' of 'results', which must have room for 'n' bits, to the result for
+ * 'flows[i]'. */
+void
+expr_program_evaluate_batch(const struct expr_program *prog,
+                            const struct flow *flows, size_t n,
+                            unsigned long *results)
+{
+    size_t n_longs = bitmap_n_longs(n);
+    if (!n_longs) {
+        return;
+    }
+
+    unsigned long stub[64];
+    size_t stack_size = prog->max_depth * n_longs;
+    unsigned long *stack = (stack_size <= ARRAY_SIZE(stub)
+                            ? stub
+                            : xmalloc(stack_size * sizeof *stack));
+    unsigned long *top = stack - n_longs;
+
+    for (size_t i = 0; i < prog->n_insns; i++) {
+        const struct expr_insn *insn = &prog->insns[i];
+
+        switch (insn->type) {
+        case EXPR_INSN_CMP:
+            top += n_longs;
+            memset(top, 0, n_longs * sizeof *top);
+            for (size_t j = 0; j < n; j++) {
+                if (expr_insn_evaluate_cmp(insn, &flows[j])) {
+                    bitmap_set1(top, j);
+                }
+            }
+            break;
+
+        case EXPR_INSN_CONST:
+            top += n_longs;
+            memset(top, insn->constant ? 0xff : 0, n_longs * sizeof *top);
+            break;
+
+        case EXPR_INSN_AND:
+        case EXPR_INSN_OR: {
+            unsigned long *dst = top - (insn->n_args - 1) * n_longs;
+            for (const unsigned long *src = dst + n_longs; src <= top;
+                 src += n_longs) {
+                if (insn->type == EXPR_INSN_AND) {
+                    for (size_t j = 0; j < n_longs; j++) {
+                        dst[j] &= src[j];
+                    }
+                } else {
+                    for (size_t j = 0; j < n_longs; j++) {
+                        dst[j] |= src[j];
+                    }
+                }
+            }
+            top = dst;
+            break;
+        }
+
+        default:
+            OVS_NOT_REACHED();
+        }
+    }
+    ovs_assert(top == stack);
+
+    memcpy(results, stack, n_longs * sizeof *results);
+    if (stack != stub) {
+        free(stack);
+    }
+}
+
+/* Evaluates 'prog' against microflow 'uflow' and returns the result. */
+bool
+expr_program_evaluate(const struct expr_program *prog,
+                      const struct flow *uflow)
+{
+    unsigned long result;
+    expr_program_evaluate_batch(prog, uflow, 1, &result);
+    return result & 1;
+}
+
 /* Action parsing helper. */
 
 /* Checks that 'f' is 'n_bits' wide (where 'n_bits == 0' means that 'f' must be
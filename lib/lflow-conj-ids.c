@@ -30,6 +30,9 @@ COVERAGE_DEFINE(lflow_conj_free_unexpected);
 struct conj_id_node {
     struct hmap_node hmap_node;
     uint32_t conj_id;
+    uint32_t range_end; /* First id after the range this id belongs to, so
+                         * that a conflicting range can be skipped at once.
+                         * 0 if the range ends at UINT32_MAX. */
 };
 
 struct lflow_conj_node {
@@ -39,6 +42,8 @@ struct lflow_conj_node {
     struct uuid dp_uuid;
     uint32_t start_conj_id;
     uint32_t n_conjs;
+    /* The ids of the range, allocated together with the node. */
+    struct conj_id_node conj_id_nodes[];
 };
 
 struct lflow_to_dps_node {
@@ -64,6 +69,20 @@ static void lflow_conj_ids_free_for_lflow_dp(struct conj_ids *,
                                              const struct uuid *dp_uuid);
 static struct lflow_to_dps_node *lflow_to_dps_find(struct conj_ids *,
                                                    const struct uuid *);
+
+static struct conj_id_node *
+conj_id_find(const struct conj_ids *conj_ids, uint32_t conj_id)
+{
+    struct conj_id_node *conj_id_node;
+    /* conj_id is both the key and the hash */
+    HMAP_FOR_EACH_WITH_HASH (conj_id_node, hmap_node, conj_id,
+                             &conj_ids->conj_id_allocations) {
+        if (conj_id_node->conj_id == conj_id) {
+            return conj_id_node;
+        }
+    }
+    return NULL;
+}
 static inline uint32_t
 hash_lflow_dp(const struct uuid *lflow_uuid, const struct uuid *dp_uuid)
 {
@@ -90,8 +109,10 @@ lflow_conj_ids_set_test_mode(bool mode)
  * The algorithm tries to allocate the hash result of the combination of the
  * lflow_uuid and dp_uuid as the first conjunction id. If it is unavailable, or
  * any of the subsequent n_conjs - 1 ids are unavailable, iterate until the
- * next available n_conjs ids are found.  Given that n_conjs is very small (in
- * most cases will be 1), the algorithm should be efficient enough and in most
+ * next available n_conjs ids are found.  On a conflict the search resumes
+ * right after the end of the conflicting range, since none of the ids in
+ * between can start a free range.  Given that n_conjs is very small (in most
+ * cases will be 1), the algorithm should be efficient enough and in most
  * cases just return the hash value, which ensures conjunction ids are
  * consistent for the same logical flow + DP in most cases.
  *
@@ -116,13 +137,15 @@ lflow_conj_ids_alloc(struct conj_ids *conj_ids, const struct uuid *lflow_uuid,
     if (start_conj_id == 0) {
         start_conj_id++;
     }
-    uint32_t initial_id = start_conj_id;
-    bool initial = true;
+    /* Number of ids passed over so far, to detect that all of them have
+     * been checked (extreme situation, not expected in real environment). */
+    uint64_t n_skipped = 0;
     while (true) {
         if (start_conj_id == 0) {
             start_conj_id++;
         }
         bool available = true;
+        uint32_t next_start = 0;
         uint32_t conj_id = start_conj_id;
         for (uint32_t i = 0; i < n_conjs; i++) {
             if (conj_id == 0) {
@@ -130,25 +153,15 @@ lflow_conj_ids_alloc(struct conj_ids *conj_ids, const struct uuid *lflow_uuid,
                  * we need a continuous range. Start over from 1 (0 is
                  * skipped). */
                 available = false;
+                next_start = 1;
                 break;
             }
-            if (!initial && conj_id == initial_id) {
-                /* It has checked all ids (extreme situation, not expected in
-                 * real environment). */
-                return 0;
-            }
-            initial = false;
-            struct conj_id_node *conj_id_node;
-            /* conj_id is both the key and the hash */
-            HMAP_FOR_EACH_WITH_HASH (conj_id_node, hmap_node, conj_id,
-                                     &conj_ids->conj_id_allocations) {
-                if (conj_id_node->conj_id == conj_id) {
-                    available = false;
-                    COVERAGE_INC(lflow_conj_conflict);
-                    break;
-                }
-            }
-            if (!available) {
+            struct conj_id_node *conj_id_node = conj_id_find(conj_ids,
+                                                             conj_id);
+            if (conj_id_node) {
+                available = false;
+                next_start = conj_id_node->range_end;
+                COVERAGE_INC(lflow_conj_conflict);
                 break;
             }
             conj_id++;
@@ -156,7 +169,17 @@ lflow_conj_ids_alloc(struct conj_ids *conj_ids, const struct uuid *lflow_uuid,
         if (available) {
             break;
         }
-        start_conj_id = conj_id + 1;
+        /* On overflow 'next_start' is 1, so this already counts id 0. */
+        n_skipped += (uint32_t) (next_start - start_conj_id);
+        if (!next_start) {
+            /* The conflicting range ends at UINT32_MAX, and id 0 is skipped
+             * when starting over. */
+            n_skipped++;
+        }
+        if (n_skipped >= UINT32_MAX) {
+            return 0;
+        }
+        start_conj_id = next_start;
     }
     lflow_conj_ids_insert_(conj_ids, lflow_uuid, dp_uuid, start_conj_id,
                            n_conjs);
@@ -181,16 +204,9 @@ lflow_conj_ids_alloc_specified(struct conj_ids *conj_ids,
 
     uint32_t conj_id = start_conj_id;
     for (uint32_t i = 0; i < n_conjs; i++) {
-        if (!conj_id) {
+        if (!conj_id || conj_id_find(conj_ids, conj_id)) {
             return false;
         }
-        struct conj_id_node *conj_id_node;
-        HMAP_FOR_EACH_WITH_HASH (conj_id_node, hmap_node, conj_id,
-                                 &conj_ids->conj_id_allocations) {
-            if (conj_id_node->conj_id == conj_id) {
-                return false;
-            }
-        }
         conj_id++;
     }
     lflow_conj_ids_insert_(conj_ids, lflow_uuid, dp_uuid, start_conj_id,
@@ -238,12 +254,7 @@ lflow_conj_ids_init(struct conj_ids *conj_ids)
 
 void
 lflow_conj_ids_destroy(struct conj_ids *conj_ids) {
-    struct conj_id_node *conj_id_node;
-    HMAP_FOR_EACH_SAFE (conj_id_node, hmap_node,
-                        &conj_ids->conj_id_allocations) {
-        hmap_remove(&conj_ids->conj_id_allocations, &conj_id_node->hmap_node);
-        free(conj_id_node);
-    }
+    /* The conj_id_nodes are owned by the lflow_conj_nodes. */
     hmap_destroy(&conj_ids->conj_id_allocations);
 
     struct lflow_conj_node *lflow_conj;
@@ -272,11 +283,13 @@ lflow_conj_ids_dump(struct conj_ids *conj_ids, struct ds *out_data)
 {
     struct lflow_conj_node *lflow_conj;
     size_t count = 0;
+    size_t n_conflicts = 0;
 
     ds_put_cstr(out_data, "Conjunction IDs allocations:\n");
     HMAP_FOR_EACH (lflow_conj, hmap_node, &conj_ids->lflow_conj_ids) {
         bool has_conflict =
             (lflow_conj->start_conj_id != lflow_conj->hmap_node.hash);
+        n_conflicts += has_conflict;
         ds_put_format(out_data, "lflow: "UUID_FMT", dp: "UUID_FMT", start: %"
                       PRIu32", n: %"PRIu32"%s\n",
                       UUID_ARGS(&lflow_conj->lflow_uuid),
@@ -289,6 +302,12 @@ lflow_conj_ids_dump(struct conj_ids *conj_ids, struct ds *out_data)
 
     ds_put_cstr(out_data, "---\n");
     ds_put_format(out_data, "Total %"PRIuSIZE" IDs used.\n", count);
+    /* Ranges that could not get the id derived from their lflow and DP are
+     * the ones that lflow_conj_ids_alloc_specified() may fail to restore
+     * after a recompute, so this is the fragmentation that matters. */
+    ds_put_format(out_data, "%"PRIuSIZE" of %"PRIuSIZE" ranges not at their "
+                  "preferred ID.\n", n_conflicts,
+                  hmap_count(&conj_ids->lflow_conj_ids));
 
     size_t allocated = hmap_count(&conj_ids->conj_id_allocations);
     if (count != allocated) {
@@ -319,16 +338,20 @@ lflow_conj_ids_insert_(struct conj_ids *conj_ids,
                        uint32_t start_conj_id, uint32_t n_conjs)
 {
     ovs_assert(n_conjs);
+    struct lflow_conj_node *lflow_conj =
+        xzalloc(sizeof *lflow_conj
+                + n_conjs * sizeof lflow_conj->conj_id_nodes[0]);
+    uint32_t range_end = start_conj_id + n_conjs;
     uint32_t conj_id = start_conj_id;
     for (uint32_t i = 0; i < n_conjs; i++) {
         ovs_assert(conj_id);
-        struct conj_id_node *node = xzalloc(sizeof *node);
+        struct conj_id_node *node = &lflow_conj->conj_id_nodes[i];
         node->conj_id = conj_id;
+        node->range_end = range_end;
         hmap_insert(&conj_ids->conj_id_allocations, &node->hmap_node, conj_id);
         conj_id++;
     }
 
-    struct lflow_conj_node *lflow_conj = xzalloc(sizeof *lflow_conj);
     lflow_conj->lflow_uuid = *lflow_uuid;
     lflow_conj->dp_uuid = *dp_uuid;
     lflow_conj->start_conj_id = start_conj_id;
@@ -370,20 +393,9 @@ lflow_conj_ids_free_(struct conj_ids *conj_ids,
 {
     ovs_assert(lflow_conj->n_conjs);
     COVERAGE_INC(lflow_conj_free);
-    uint32_t conj_id = lflow_conj->start_conj_id;
     for (uint32_t i = 0; i < lflow_conj->n_conjs; i++) {
-        ovs_assert(conj_id);
-        struct conj_id_node *conj_id_node;
-        HMAP_FOR_EACH_WITH_HASH (conj_id_node, hmap_node, conj_id,
-                                 &conj_ids->conj_id_allocations) {
-            if (conj_id_node->conj_id == conj_id) {
-                hmap_remove(&conj_ids->conj_id_allocations,
-                            &conj_id_node->hmap_node);
-                free(conj_id_node);
-                break;
-            }
-        }
-        conj_id++;
+        hmap_remove(&conj_ids->conj_id_allocations,
+                    &lflow_conj->conj_id_nodes[i].hmap_node);
     }
 
     hmap_remove(&conj_ids->lflow_conj_ids, &lflow_conj->hmap_node);
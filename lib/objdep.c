@@ -20,6 +20,7 @@
 #include "lib/hash.h"
 #include "lib/util.h"
 #include "openvswitch/vlog.h"
+#include "simap.h"
 
 VLOG_DEFINE_THIS_MODULE(resource_dep);
 
@@ -30,6 +31,8 @@ objdep_mgr_init(struct objdep_mgr *mgr)
 {
     hmap_init(&mgr->resource_to_objects_table);
     hmap_init(&mgr->object_to_resources_table);
+    mgr->n_refs = 0;
+    mgr->res_names_usage = 0;
 }
 
 void
@@ -62,6 +65,8 @@ objdep_mgr_clear(struct objdep_mgr *mgr)
         hmap_remove(&mgr->object_to_resources_table, &object_node->node);
         free(object_node);
     }
+    mgr->n_refs = 0;
+    mgr->res_names_usage = 0;
 }
 
 void
@@ -83,9 +88,9 @@ objdep_mgr_add_with_refcount(struct objdep_mgr *mgr, enum objdep_type type,
     if (resource_node && object_node) {
         /* Check if the mapping already existed before adding a new one. */
         struct object_to_resources_list_node *n;
-        HMAP_FOR_EACH_WITH_HASH (n, hmap_node, uuid_hash(obj_uuid),
+        HMAP_FOR_EACH_WITH_HASH (n, hmap_node, object_node->node.hash,
                                  &resource_node->objs) {
-            if (uuid_equals(&n->obj_uuid, obj_uuid)) {
+            if (n->object_node == object_node) {
                 return;
             }
         }
@@ -94,10 +99,12 @@ objdep_mgr_add_with_refcount(struct objdep_mgr *mgr, enum objdep_type type,
     /* Create the resource node if we didn't have one already (for a
      * different object). */
     if (!resource_node) {
-        resource_node = xzalloc(sizeof *resource_node);
+        size_t name_len = strlen(res_name) + 1;
+        resource_node = xzalloc(sizeof *resource_node + name_len);
         resource_node->node.hash = hash_string(res_name, type);
         resource_node->type = type;
-        resource_node->res_name = xstrdup(res_name);
+        memcpy(resource_node->res_name, res_name, name_len);
+        mgr->res_names_usage += name_len;
         hmap_init(&resource_node->objs);
         hmap_insert(&mgr->resource_to_objects_table,
                     &resource_node->node,
@@ -118,13 +125,14 @@ objdep_mgr_add_with_refcount(struct objdep_mgr *mgr, enum objdep_type type,
 
     struct object_to_resources_list_node *resource_list_node =
         xzalloc(sizeof *resource_list_node);
-    resource_list_node->obj_uuid = *obj_uuid;
+    resource_list_node->object_node = object_node;
     resource_list_node->ref_count = ref_count;
     resource_list_node->resource_node = resource_node;
     hmap_insert(&resource_node->objs, &resource_list_node->hmap_node,
-                uuid_hash(obj_uuid));
+                object_node->node.hash);
     ovs_list_push_back(&object_node->resources_head,
                        &resource_list_node->list_node);
+    mgr->n_refs++;
 }
 
 void
@@ -150,10 +158,12 @@ objdep_mgr_remove_obj(struct objdep_mgr *mgr, const struct uuid *obj_uuid)
          * referred by any logical flows. */
         if (hmap_is_empty(&resource_node->objs)) {
             hmap_remove(&mgr->resource_to_objects_table, &resource_node->node);
+            mgr->res_names_usage -= strlen(resource_node->res_name) + 1;
             resource_node_destroy(resource_list_node->resource_node);
         }
 
         free(resource_list_node);
+        mgr->n_refs--;
     }
     free(object_node);
 }
@@ -217,12 +227,12 @@ objdep_mgr_handle_change(struct objdep_mgr *mgr,
     struct uuidset objs_todo = UUIDSET_INITIALIZER(&objs_todo);
     struct object_to_resources_list_node *resource_list_node;
     HMAP_FOR_EACH (resource_list_node, hmap_node, &resource_node->objs) {
-        if (uuidset_find(objs_processed, &resource_list_node->obj_uuid)) {
+        const struct uuid *obj_uuid =
+            &resource_list_node->object_node->obj_uuid;
+        if (uuidset_find(objs_processed, obj_uuid)) {
             continue;
         }
-        /* Use object_to_resources_list_node as list node to store the uuid.
-         * Other fields are not used here. */
-        uuidset_insert(&objs_todo, &resource_list_node->obj_uuid);
+        uuidset_insert(&objs_todo, obj_uuid);
     }
     if (uuidset_is_empty(&objs_todo)) {
         return true;
@@ -248,10 +258,40 @@ objdep_type_name(enum objdep_type type)
     return type_names[type];
 }
 
+/* Returns the size of the bucket array allocated for 'hmap'.  An hmap with
+ * a single bucket uses the one embedded in it. */
+static size_t
+hmap_buckets_usage(const struct hmap *hmap)
+{
+    return hmap->mask ? (hmap->mask + 1) * sizeof *hmap->buckets : 0;
+}
+
+void
+objdep_mgr_get_memory_usage(const struct objdep_mgr *mgr, const char *name,
+                            struct simap *usage)
+{
+    size_t n_resources = hmap_count(&mgr->resource_to_objects_table);
+    size_t n_objs = hmap_count(&mgr->object_to_resources_table);
+    size_t mem = n_resources * sizeof(struct resource_to_objects_node)
+                 + mgr->res_names_usage
+                 + n_objs * sizeof(struct object_to_resources_node)
+                 + mgr->n_refs * sizeof(struct object_to_resources_list_node)
+                 + hmap_buckets_usage(&mgr->resource_to_objects_table)
+                 + hmap_buckets_usage(&mgr->object_to_resources_table);
+
+    const struct resource_to_objects_node *resource_node;
+    HMAP_FOR_EACH (resource_node, node, &mgr->resource_to_objects_table) {
+        mem += hmap_buckets_usage(&resource_node->objs);
+    }
+
+    char *key = xasprintf("%s_usage-KB", name);
+    simap_increase(usage, key, ROUND_UP(mem, 1024) / 1024);
+    free(key);
+}
+
 static void
 resource_node_destroy(struct resource_to_objects_node *resource_node)
 {
-    free(resource_node->res_name);
     hmap_destroy(&resource_node->objs);
     free(resource_node);
 }
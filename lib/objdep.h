@@ -21,6 +21,8 @@
 #include "openvswitch/hmap.h"
 #include "openvswitch/list.h"
 
+struct simap;
+
 enum objdep_type {
     OBJDEP_TYPE_ADDRSET,
     OBJDEP_TYPE_PORTGROUP,
@@ -42,11 +44,11 @@ typedef bool (*objdep_change_handler)(enum objdep_type,
 struct resource_to_objects_node {
     struct hmap_node node; /* node in objdep_mgr.resource_to_objects_table. */
     enum objdep_type type; /* key */
-    char *res_name;        /* key */
     struct hmap objs;      /* Contains object_to_resources_list_node.
                             * Use hmap instead of list so
                             * that obj_resource_add() can check and avoid
                             * and redundant entries in O(1). */
+    char res_name[];       /* key, stored inline to save an allocation. */
 };
 
 #define RESOURCE_FOR_EACH_OBJ(NODE, MAP) \
@@ -68,8 +70,9 @@ struct object_to_resources_node {
 struct object_to_resources_list_node {
     /* node in object_to_resources_node.resources_head. */
     struct ovs_list list_node;
-    struct hmap_node hmap_node; /* node in resource_to_objects_node.objs. */
-    struct uuid obj_uuid;
+    struct hmap_node hmap_node; /* node in resource_to_objects_node.objs,
+                                 * hashed by the object's uuid. */
+    struct object_to_resources_node *object_node;
     size_t ref_count; /* Reference count of the resource by this object.
                        * Currently only used for the resource type
                        * OBJDEP_TYPE_ADDRSET and for other types always
@@ -90,6 +93,11 @@ struct objdep_mgr {
      * struct object_to_resources_node. The resources_head in each node
      * points to a list of object_to_resources_list_node.obj_list. */
     struct hmap object_to_resources_table;
+
+    /* Number of object_to_resources_list_nodes, i.e. of edges. */
+    size_t n_refs;
+    /* Bytes used by resource names. */
+    size_t res_names_usage;
 };
 
 void objdep_mgr_init(struct objdep_mgr *);
@@ -120,4 +128,7 @@ bool objdep_mgr_handle_change(struct objdep_mgr *, enum objdep_type,
 
 const char *objdep_type_name(enum objdep_type);
 
+void objdep_mgr_get_memory_usage(const struct objdep_mgr *, const char *name,
+                                 struct simap *usage);
+
 #endif /* lib/objdep.h */
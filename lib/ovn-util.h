@@ -19,6 +19,7 @@
 #include "openvswitch/meta-flow.h"
 #include "ovsdb-idl.h"
 #include "lib/bitmap.h"
+#include "lib/hash.h"
 #include "lib/packets.h"
 #include "lib/sset.h"
 #include "lib/svec.h"
@@ -509,11 +510,14 @@ void sorted_array_apply_diff(const struct sorted_array *a1,
                                                     bool add),
                              const void *arg);
 
-/* */
+/* A bitmap that keeps track of its number of 1-bits and of a hash of its
+ * contents as bits are set and cleared, so that dynamic_bitmap_hash() is
+ * O(1).  Modify 'map' only through the dynamic_bitmap_*() functions. */
 struct dynamic_bitmap {
     unsigned long *map;
     size_t n_elems;
     size_t capacity;
+    uint32_t content_hash;  /* XOR of hash_int() of the indexes of 1-bits. */
 };
 
 static inline unsigned long *
@@ -556,6 +560,7 @@ dynamic_bitmap_alloc(struct dynamic_bitmap *db, size_t n_elems)
     db->map = bitmap_allocate(n_elems);
     db->capacity = n_elems;
     db->n_elems = 0;
+    db->content_hash = 0;
 }
 
 static inline void
@@ -597,6 +602,14 @@ dynamic_bitmap_count1(const struct dynamic_bitmap *db)
     return bitmap_count1(db->map, db->capacity);
 }
 
+/* Returns a hash of the set of 1-bits in 'db'.  Bitmaps that are
+ * dynamic_bitmap_equal() have the same hash, regardless of capacity. */
+static inline uint32_t
+dynamic_bitmap_hash(const struct dynamic_bitmap *db)
+{
+    return hash_int(db->content_hash, db->n_elems);
+}
+
 static inline void
 dynamic_bitmap_set1(struct dynamic_bitmap *db, int index)
 {
@@ -604,6 +617,7 @@ dynamic_bitmap_set1(struct dynamic_bitmap *db, int index)
     if (!dynamic_bitmap_is_set(db, index)) {
         bitmap_set1(db->map, index);
         db->n_elems++;
+        db->content_hash ^= hash_int(index, 0);
     }
 }
 
@@ -614,6 +628,7 @@ dynamic_bitmap_set0(struct dynamic_bitmap *db, int index)
     if (dynamic_bitmap_is_set(db, index)) {
         bitmap_set0(db->map, index);
         db->n_elems--;
+        db->content_hash ^= hash_int(index, 0);
     }
 }
 
@@ -622,7 +637,17 @@ dynamic_bitmap_or(struct dynamic_bitmap *db,
                   const unsigned long *arg, size_t n)
 {
     ovs_assert(db->capacity == n);
-    bitmap_or(db->map, arg, n);
+    for (size_t i = 0; i < bitmap_n_longs(n); i++) {
+        unsigned long added = arg[i] & ~db->map[i];
+
+        db->map[i] |= added;
+        for (; added; added &= added - 1) {
+            size_t index = i * BITMAP_ULONG_BITS + raw_ctz(added);
+
+            db->n_elems++;
+            db->content_hash ^= hash_int(index, 0);
+        }
+    }
 }
 
 static inline unsigned long *
@@ -648,6 +673,7 @@ dynamic_bitmap_clone_from_db(struct dynamic_bitmap *dst,
     dst->map = dynamic_bitmap_clone_map(orig);
     dst->n_elems = dynamic_bitmap_count1(orig);
     dst->capacity = orig->capacity;
+    dst->content_hash = orig->content_hash;
 }
 
 static inline size_t
@@ -18,6 +18,8 @@
 
 #include "tests/ovstest.h"
 #include "tests/test-utils.h"
+#include "random.h"
+#include "timeval.h"
 #include "util.h"
 #include "lib/uuid.h"
 
@@ -118,6 +120,85 @@ done:
     lflow_conj_ids_destroy(&conj_ids);
 }
 
+/* Generates a logical flow uuid.  With 'wrap', the preferred id of the flow
+ * is within 'n_ids' of the end of the id space, so that allocations have
+ * to wrap around to the beginning of it. */
+static void
+stress_lflow_uuid(struct uuid *uuid, bool wrap, uint32_t n_ids)
+{
+    uuid_generate(uuid);
+    if (wrap) {
+        uuid->parts[0] = UINT32_MAX - random_range(MAX(n_ids, 1));
+    }
+}
+
+/* Allocates ranges for n_lflows logical flows, then for n_rounds replaces
+ * every other one of them with a new logical flow, checking that no id is
+ * leaked.  If "wrap" is given, the preferred ids are at the end of the id
+ * space.  The time taken is reported on stderr. */
+static void
+test_conj_ids_stress(struct ovs_cmdl_context *ctx)
+{
+    unsigned int shift = 1;
+    unsigned int n_lflows;
+    unsigned int n_conjs;
+    unsigned int n_rounds;
+    struct uuid dp_uuid = UUID_ZERO;
+
+    if (!test_read_uint_value(ctx, shift++, "n_lflows", &n_lflows) ||
+        !test_read_uint_value(ctx, shift++, "n_conjs", &n_conjs) ||
+        !test_read_uint_value(ctx, shift++, "n_rounds", &n_rounds)) {
+        return;
+    }
+
+    bool wrap = false;
+    if (ctx->argc > shift) {
+        const char *mode = test_read_value(ctx, shift++, "mode");
+        if (strcmp(mode, "wrap")) {
+            printf("Unknown mode: %s\n", mode);
+            return;
+        }
+        wrap = true;
+    }
+    uint32_t n_ids = n_lflows * n_conjs;
+
+    struct conj_ids conj_ids;
+    lflow_conj_ids_init(&conj_ids);
+    lflow_conj_ids_set_test_mode(true);
+
+    struct uuid *lflows = xmalloc(n_lflows * sizeof *lflows);
+    size_t n_failed = 0;
+    long long int start = time_msec();
+    for (unsigned int i = 0; i < n_lflows; i++) {
+        stress_lflow_uuid(&lflows[i], wrap, n_ids);
+        n_failed += !lflow_conj_ids_alloc(&conj_ids, &lflows[i], &dp_uuid,
+                                          n_conjs);
+    }
+    for (unsigned int r = 0; r < n_rounds; r++) {
+        for (unsigned int i = r % 2; i < n_lflows; i += 2) {
+            lflow_conj_ids_free(&conj_ids, &lflows[i]);
+            stress_lflow_uuid(&lflows[i], wrap, n_ids);
+            n_failed += !lflow_conj_ids_alloc(&conj_ids, &lflows[i],
+                                              &dp_uuid, n_conjs);
+        }
+    }
+    fprintf(stderr, "%u lflows, %u rounds: %lld ms\n", n_lflows, n_rounds,
+            time_msec() - start);
+
+    size_t n_used = 0;
+    for (unsigned int i = 0; i < n_lflows; i++) {
+        if (lflow_conj_ids_find(&conj_ids, &lflows[i], &dp_uuid)) {
+            n_used += n_conjs;
+        }
+    }
+    size_t n_allocated = hmap_count(&conj_ids.conj_id_allocations);
+    printf("failed: %"PRIuSIZE", leaked: %"PRIuSIZE"\n", n_failed,
+           n_allocated - n_used);
+
+    free(lflows);
+    lflow_conj_ids_destroy(&conj_ids);
+}
+
 static void
 test_lflow_conj_ids_main(int argc, char *argv[])
 {
@@ -125,6 +206,7 @@ test_lflow_conj_ids_main(int argc, char *argv[])
     static const struct ovs_cmdl_command commands[] = {
         {"operations", NULL, 1, INT_MAX,
          test_conj_ids_operations, OVS_RO},
+        {"stress", NULL, 3, 4, test_conj_ids_stress, OVS_RO},
         {NULL, NULL, 0, 0, NULL, OVS_RO},
     };
     struct ovs_cmdl_context ctx;
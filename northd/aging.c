@@ -16,6 +16,8 @@
 #include <config.h>
 
 #include "en-global-config.h"
+#include "hash.h"
+#include "heap.h"
 #include "lib/inc-proc-eng.h"
 #include "lib/ovn-nb-idl.h"
 #include "lib/ovn-sb-idl.h"
@@ -26,6 +28,7 @@
 #include "openvswitch/poll-loop.h"
 #include "openvswitch/util.h"
 #include "openvswitch/vlog.h"
+#include "uuid.h"
 
 VLOG_DEFINE_THIS_MODULE(mac_binding_aging);
 
@@ -62,7 +65,7 @@ struct threshold_entry {
  * "Logical_Router:options:mac_binding_age_threshold".
  *
  * This struct is also used for non-CIDR-based threshold, e.g. the ones from
- * "NB_Global:other_config:fdb_age_threshold" for the common aging_context
+ * "NB_Global:other_config:fdb_age_threshold" for the common aging index
  * interface.
  *
  * - The arrays `v4_entries` and `v6_entries` are populated with parsed entries
@@ -286,64 +289,286 @@ min_mac_binding_age_threshold(const char *opt)
     return threshold == UINT_MAX ? 0 : threshold;
 }
 
-struct aging_context {
-    int64_t next_wake_ms;
-    int64_t time_wall_now;
-    uint32_t removal_limit;
-    uint32_t n_removed;
-    struct threshold_config *threshold;
+/* Expiration index.
+ *
+ * Keeps every MAC_Binding or FDB row that can age out in a heap ordered by
+ * the time at which it expires, so that a run only looks at the rows that are
+ * actually due instead of walking all of them.  The index follows the tracked
+ * changes to the SB table and is rebuilt from scratch only when the set of
+ * datapaths or their aging thresholds change. */
+struct aging_entry {
+    struct hmap_node hmap_node; /* In aging_index's 'entries', by 'uuid'. */
+    struct heap_node heap_node; /* In aging_index's 'expiry'. */
+    struct uuid uuid;           /* UUID of the SB row. */
+    int64_t expire_msec;        /* Wall clock time when the row expires. */
+};
+
+/* Aging thresholds of a datapath, parsed once per change of the option. */
+struct aging_datapath {
+    struct hmap_node node;      /* In aging_index's 'datapaths'. */
+    int64_t tunnel_key;         /* SB datapath tunnel key. */
+    char *threshold_opt;        /* Unparsed threshold option, may be NULL. */
+    struct threshold_config config;
+};
+
+struct aging_index {
+    struct hmap entries;        /* Contains "struct aging_entry"s. */
+    struct heap expiry;         /* Earliest expiration on top. */
+    struct hmap datapaths;      /* Contains "struct aging_datapath"s. */
+    bool valid;                 /* False if it must be rebuilt. */
 };
 
-static struct aging_context
-aging_context_init(uint32_t removal_limit)
+/* Returns the threshold option of 'od'. */
+typedef const char *aging_threshold_opt_func(const struct ovn_datapath *od);
+
+/* Parses threshold option 'opt', which may be NULL, into 'config'. */
+typedef void aging_threshold_parse_func(const char *opt,
+                                        struct threshold_config *config);
+
+static struct aging_index *
+aging_index_create(void)
 {
-    struct aging_context ctx = {
-           .next_wake_ms = INT64_MAX,
-           .time_wall_now = time_wall_msec(),
-           .removal_limit = removal_limit,
-           .n_removed = 0,
-           .threshold = NULL,
-    };
-    return ctx;
+    struct aging_index *index = xmalloc(sizeof *index);
+
+    hmap_init(&index->entries);
+    heap_init(&index->expiry);
+    hmap_init(&index->datapaths);
+    index->valid = false;
+
+    return index;
 }
 
 static void
-aging_context_set_threshold(struct aging_context *ctx,
-                            struct threshold_config *threshold)
+aging_index_clear(struct aging_index *index)
 {
-    ctx->threshold = threshold;
+    struct aging_entry *entry;
+    HMAP_FOR_EACH_POP (entry, hmap_node, &index->entries) {
+        free(entry);
+    }
+    heap_clear(&index->expiry);
+
+    struct aging_datapath *dp;
+    HMAP_FOR_EACH_POP (dp, node, &index->datapaths) {
+        threshold_config_destroy(&dp->config);
+        free(dp->threshold_opt);
+        free(dp);
+    }
+    index->valid = false;
 }
 
-static bool
-aging_context_is_at_limit(struct aging_context *ctx)
+static void
+aging_index_destroy(struct aging_index *index)
 {
-    return ctx->removal_limit && ctx->n_removed == ctx->removal_limit;
+    if (!index) {
+        return;
+    }
+
+    aging_index_clear(index);
+    hmap_destroy(&index->entries);
+    heap_destroy(&index->expiry);
+    hmap_destroy(&index->datapaths);
+    free(index);
 }
 
-static bool
-aging_context_handle_timestamp(struct aging_context *ctx, int64_t timestamp,
-                               const char *ip)
+static struct aging_datapath *
+aging_index_find_datapath(const struct aging_index *index, int64_t tunnel_key)
 {
-    int64_t elapsed = ctx->time_wall_now - timestamp;
-    if (elapsed < 0) {
-        return false;
+    struct aging_datapath *dp;
+
+    HMAP_FOR_EACH_WITH_HASH (dp, node, hash_uint64(tunnel_key),
+                             &index->datapaths) {
+        if (dp->tunnel_key == tunnel_key) {
+            return dp;
+        }
     }
+    return NULL;
+}
 
-    ovs_assert(ctx->threshold);
+static struct aging_entry *
+aging_index_find_entry(const struct aging_index *index,
+                       const struct uuid *uuid)
+{
+    struct aging_entry *entry;
+
+    HMAP_FOR_EACH_WITH_HASH (entry, hmap_node, uuid_hash(uuid),
+                             &index->entries) {
+        if (uuid_equals(&entry->uuid, uuid)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void
+aging_index_remove_entry(struct aging_index *index, struct aging_entry *entry)
+{
+    hmap_remove(&index->entries, &entry->hmap_node);
+    heap_remove(&index->expiry, &entry->heap_node);
+    free(entry);
+}
+
+static void
+aging_index_remove(struct aging_index *index, const struct uuid *uuid)
+{
+    struct aging_entry *entry = aging_index_find_entry(index, uuid);
+    if (entry) {
+        aging_index_remove_entry(index, entry);
+    }
+}
+
+/* The heap keeps the highest priority on top, so the earliest expiration
+ * must map to the highest priority. */
+static uint64_t
+aging_expiry_priority(int64_t expire_msec)
+{
+    return UINT64_MAX - (uint64_t) expire_msec;
+}
+
+/* Adds or updates the row with the given 'uuid', last refreshed at
+ * 'timestamp' in the datapath with 'tunnel_key'.  'ip' is the IP address of
+ * MAC bindings, for CIDR-based thresholds, and NULL for FDB entries. */
+static void
+aging_index_update(struct aging_index *index, const struct uuid *uuid,
+                   int64_t tunnel_key, int64_t timestamp, const char *ip)
+{
+    const struct aging_datapath *dp =
+        aging_index_find_datapath(index, tunnel_key);
     uint64_t threshold =
-            1000 * (uint64_t) find_threshold_for_ip(ip, ctx->threshold);
+        dp ? 1000 * (uint64_t) find_threshold_for_ip(ip, &dp->config) : 0;
+    struct aging_entry *entry = aging_index_find_entry(index, uuid);
 
     if (!threshold) {
-        return false;
+        if (entry) {
+            aging_index_remove_entry(index, entry);
+        }
+        return;
     }
 
-    if (elapsed >= threshold) {
-        ctx->n_removed++;
-        return true;
+    int64_t expire_msec = timestamp + threshold;
+    if (entry) {
+        entry->expire_msec = expire_msec;
+        heap_change(&index->expiry, &entry->heap_node,
+                    aging_expiry_priority(expire_msec));
+    } else {
+        entry = xmalloc(sizeof *entry);
+        entry->uuid = *uuid;
+        entry->expire_msec = expire_msec;
+        hmap_insert(&index->entries, &entry->hmap_node, uuid_hash(uuid));
+        heap_insert(&index->expiry, &entry->heap_node,
+                    aging_expiry_priority(expire_msec));
     }
+}
 
-    ctx->next_wake_ms = MIN(ctx->next_wake_ms, (threshold - elapsed));
-    return false;
+/* Returns true if the datapaths in 'datapaths', or their threshold options
+ * as returned by 'get_opt', differ from the ones 'index' was built for. */
+static bool
+aging_index_datapaths_changed(const struct aging_index *index,
+                              const struct hmap *datapaths,
+                              aging_threshold_opt_func *get_opt)
+{
+    const struct ovn_datapath *od;
+    size_t n = 0;
+
+    HMAP_FOR_EACH (od, key_node, datapaths) {
+        if (!od->sdp->sb_dp) {
+            continue;
+        }
+
+        const struct aging_datapath *dp =
+            aging_index_find_datapath(index, od->sdp->sb_dp->tunnel_key);
+        if (!dp || !nullable_string_is_equal(dp->threshold_opt,
+                                             get_opt(od))) {
+            return true;
+        }
+        n++;
+    }
+    return n != hmap_count(&index->datapaths);
+}
+
+/* Empties 'index' and sets it up for the datapaths in 'datapaths'.  The
+ * caller must then add the rows with aging_index_update(). */
+static void
+aging_index_reset(struct aging_index *index, const struct hmap *datapaths,
+                  aging_threshold_opt_func *get_opt,
+                  aging_threshold_parse_func *parse)
+{
+    const struct ovn_datapath *od;
+
+    aging_index_clear(index);
+    HMAP_FOR_EACH (od, key_node, datapaths) {
+        if (!od->sdp->sb_dp) {
+            continue;
+        }
+
+        struct aging_datapath *dp = xmalloc(sizeof *dp);
+        dp->tunnel_key = od->sdp->sb_dp->tunnel_key;
+        dp->threshold_opt = nullable_xstrdup(get_opt(od));
+        parse(dp->threshold_opt, &dp->config);
+        hmap_insert(&index->datapaths, &dp->node,
+                    hash_uint64(dp->tunnel_key));
+    }
+    index->valid = true;
+}
+
+/* Returns the number of milliseconds until the earliest expiration in
+ * 'index', or INT64_MAX if nothing can expire. */
+static int64_t
+aging_index_next_expiry_ms(const struct aging_index *index)
+{
+    if (heap_is_empty(&index->expiry)) {
+        return INT64_MAX;
+    }
+
+    const struct aging_entry *entry = CONTAINER_OF(heap_max(&index->expiry),
+                                                   struct aging_entry,
+                                                   heap_node);
+    return MAX(0, entry->expire_msec - time_wall_msec());
+}
+
+/* Deletes the rows in 'index' that are already expired, calling
+ * 'delete_row' with 'table' and each row's UUID, stopping after
+ * 'removal_limit' rows if it is nonzero.  Returns the number of
+ * milliseconds until the next run should happen, or INT64_MAX if none is
+ * needed. */
+static int64_t
+aging_index_run(struct aging_index *index, uint32_t removal_limit,
+                void (*delete_row)(const void *table, const struct uuid *),
+                const void *table)
+{
+    int64_t now = time_wall_msec();
+    uint32_t n_removed = 0;
+
+    while (!heap_is_empty(&index->expiry)) {
+        struct aging_entry *entry = CONTAINER_OF(heap_max(&index->expiry),
+                                                 struct aging_entry,
+                                                 heap_node);
+        if (entry->expire_msec > now) {
+            return entry->expire_msec - now;
+        }
+
+        delete_row(table, &entry->uuid);
+        aging_index_remove_entry(index, entry);
+
+        if (removal_limit && ++n_removed == removal_limit) {
+            /* Schedule the next run after specified delay. */
+            return AGING_BULK_REMOVAL_DELAY_MSEC;
+        }
+    }
+    return INT64_MAX;
+}
+
+/* Wakes up 'waker' in time for the earliest expiration in 'index', unless
+ * it is already scheduled.  A wake up that is already scheduled is left
+ * alone, so that changes to the SB table do not override the delay between
+ * bulk removals. */
+static void
+aging_waker_schedule_for_index(struct aging_waker *waker,
+                               const struct aging_index *index)
+{
+    if (!waker->should_schedule) {
+        aging_waker_schedule_next_wake(waker,
+                                       aging_index_next_expiry_ms(index));
+    }
 }
 
 static uint32_t
@@ -354,104 +579,155 @@ get_removal_limit(struct engine_node *node, const char *name)
 
     return smap_get_uint(&global_config->nb_options, name, 0);
 }
-
 /* MAC binding aging */
+static const char *
+mac_binding_age_threshold_opt(const struct ovn_datapath *od)
+{
+    ovs_assert(od->nbr);
+    return smap_get(&od->nbr->options, "mac_binding_age_threshold");
+}
+
 static void
-mac_binding_aging_run_for_datapath(const struct sbrec_datapath_binding *dp,
-                                   struct ovsdb_idl_index *mb_by_datapath,
-                                   struct aging_context *ctx)
+mac_binding_age_threshold_parse(const char *opt,
+                                struct threshold_config *config)
 {
-    if (!ctx->threshold) {
-        return;
+    if (!parse_aging_threshold(opt, config)) {
+        memset(config, 0, sizeof *config);
     }
+}
 
-    if (!ctx->threshold->n_v4_entries && !ctx->threshold->n_v6_entries
-        && !ctx->threshold->default_threshold) {
-        return;
+static void
+mac_binding_aging_update(struct aging_index *index,
+                         const struct sbrec_mac_binding *mb)
+{
+    if (mb->datapath) {
+        aging_index_update(index, &mb->header_.uuid, mb->datapath->tunnel_key,
+                           mb->timestamp, mb->ip);
+    } else {
+        aging_index_remove(index, &mb->header_.uuid);
     }
+}
 
-    struct sbrec_mac_binding *mb_index_row =
-        sbrec_mac_binding_index_init_row(mb_by_datapath);
-    sbrec_mac_binding_index_set_datapath(mb_index_row, dp);
-
+static void
+mac_binding_aging_handle_tracked(struct aging_index *index,
+                                 const struct sbrec_mac_binding_table *table)
+{
     const struct sbrec_mac_binding *mb;
-    SBREC_MAC_BINDING_FOR_EACH_EQUAL (mb, mb_index_row, mb_by_datapath) {
-        if (aging_context_handle_timestamp(ctx, mb->timestamp, mb->ip)) {
-            sbrec_mac_binding_delete(mb);
-            if (aging_context_is_at_limit(ctx)) {
-                break;
-            }
+
+    SBREC_MAC_BINDING_TABLE_FOR_EACH_TRACKED (mb, table) {
+        if (sbrec_mac_binding_is_deleted(mb)) {
+            aging_index_remove(index, &mb->header_.uuid);
+        } else {
+            mac_binding_aging_update(index, mb);
         }
     }
-    sbrec_mac_binding_index_destroy_row(mb_index_row);
+}
+
+static void
+mac_binding_delete(const void *table, const struct uuid *uuid)
+{
+    const struct sbrec_mac_binding *mb =
+        sbrec_mac_binding_table_get_for_uuid(table, uuid);
+    if (mb) {
+        sbrec_mac_binding_delete(mb);
+    }
 }
 
 enum engine_node_state
-en_mac_binding_aging_run(struct engine_node *node, void *data OVS_UNUSED)
+en_mac_binding_aging_run(struct engine_node *node, void *data)
 {
     struct northd_data *northd_data = engine_get_input_data("northd", node);
     struct ed_type_global_config *global_config =
         engine_get_input_data("global_config", node);
+    const struct sbrec_mac_binding_table *sbrec_mac_binding_table =
+        EN_OVSDB_GET(engine_get_input("SB_mac_binding", node));
+    struct aging_index *index = data;
 
     struct aging_waker *waker =
         engine_get_input_data("mac_binding_aging_waker", node);
 
-    if (!global_config->features.mac_binding_timestamp ||
-        time_msec() < waker->next_wake_msec) {
+    if (!global_config->features.mac_binding_timestamp) {
+        aging_index_clear(index);
         return EN_STALE;
     }
 
-    uint32_t limit = get_removal_limit(node, "mac_binding_removal_limit");
-    struct aging_context ctx = aging_context_init(limit);
-
-    struct ovsdb_idl_index *sbrec_mac_binding_by_datapath =
-        engine_ovsdb_node_get_index(engine_get_input("SB_mac_binding", node),
-                                    "sbrec_mac_binding_by_datapath");
+    const struct hmap *lr_datapaths = &northd_data->lr_datapaths.datapaths;
+    if (!index->valid || engine_get_force_recompute()
+        || aging_index_datapaths_changed(index, lr_datapaths,
+                                         mac_binding_age_threshold_opt)) {
+        aging_index_reset(index, lr_datapaths, mac_binding_age_threshold_opt,
+                          mac_binding_age_threshold_parse);
 
-    struct ovn_datapath *od;
-    HMAP_FOR_EACH (od, key_node, &northd_data->lr_datapaths.datapaths) {
-        ovs_assert(od->nbr);
-
-        if (!od->sdp->sb_dp) {
-            continue;
+        const struct sbrec_mac_binding *mb;
+        SBREC_MAC_BINDING_TABLE_FOR_EACH (mb, sbrec_mac_binding_table) {
+            mac_binding_aging_update(index, mb);
         }
+    } else {
+        /* A failed change handler for another input may have skipped ours
+         * in this iteration. */
+        mac_binding_aging_handle_tracked(index, sbrec_mac_binding_table);
+    }
 
-        struct threshold_config threshold_config;
-        if (!parse_aging_threshold(smap_get(&od->nbr->options,
-                                            "mac_binding_age_threshold"),
-                                   &threshold_config)) {
-            continue;
-        }
+    if (time_msec() < waker->next_wake_msec) {
+        aging_waker_schedule_for_index(waker, index);
+        return EN_STALE;
+    }
 
-        aging_context_set_threshold(&ctx, &threshold_config);
+    uint32_t limit = get_removal_limit(node, "mac_binding_removal_limit");
+    int64_t next_wake_ms = aging_index_run(index, limit, mac_binding_delete,
+                                           sbrec_mac_binding_table);
+    aging_waker_schedule_next_wake(waker, next_wake_ms);
 
-        mac_binding_aging_run_for_datapath(od->sdp->sb_dp,
-                                           sbrec_mac_binding_by_datapath,
-                                           &ctx);
-        threshold_config_destroy(&threshold_config);
+    return EN_UPDATED;
+}
 
-        if (aging_context_is_at_limit(&ctx)) {
-            /* Schedule the next run after specified delay. */
-            ctx.next_wake_ms = AGING_BULK_REMOVAL_DELAY_MSEC;
-            break;
-        }
+enum engine_input_handler_result
+mac_binding_aging_sb_mac_binding_handler(struct engine_node *node, void *data)
+{
+    struct aging_index *index = data;
+
+    if (!index->valid) {
+        /* The next run builds the index from scratch. */
+        return EN_HANDLED_UNCHANGED;
     }
 
-    aging_waker_schedule_next_wake(waker, ctx.next_wake_ms);
+    const struct sbrec_mac_binding_table *sbrec_mac_binding_table =
+        EN_OVSDB_GET(engine_get_input("SB_mac_binding", node));
+    struct aging_waker *waker =
+        engine_get_input_data("mac_binding_aging_waker", node);
+
+    mac_binding_aging_handle_tracked(index, sbrec_mac_binding_table);
+    aging_waker_schedule_for_index(waker, index);
 
-    return EN_UPDATED;
+    return EN_HANDLED_UNCHANGED;
+}
+
+enum engine_input_handler_result
+mac_binding_aging_northd_handler(struct engine_node *node, void *data)
+{
+    struct northd_data *northd_data = engine_get_input_data("northd", node);
+    struct aging_index *index = data;
+
+    if (index->valid
+        && aging_index_datapaths_changed(index,
+                                         &northd_data->lr_datapaths.datapaths,
+                                         mac_binding_age_threshold_opt)) {
+        return EN_UNHANDLED;
+    }
+    return EN_HANDLED_UNCHANGED;
 }
 
 void *
 en_mac_binding_aging_init(struct engine_node *node OVS_UNUSED,
                           struct engine_arg *arg OVS_UNUSED)
 {
-    return NULL;
+    return aging_index_create();
 }
 
 void
-en_mac_binding_aging_cleanup(void *data OVS_UNUSED)
+en_mac_binding_aging_cleanup(void *data)
 {
+    aging_index_destroy(data);
 }
 
 /* The waker node is an input node, but the data about when to wake up
@@ -496,87 +772,142 @@ en_mac_binding_aging_waker_cleanup(void *data OVS_UNUSED)
 }
 
 /* FDB aging */
+static const char *
+fdb_age_threshold_opt(const struct ovn_datapath *od)
+{
+    ovs_assert(od->nbs);
+    return smap_get(&od->nbs->other_config, "fdb_age_threshold");
+}
+
 static void
-fdb_run_for_datapath(const struct sbrec_datapath_binding *dp,
-                     struct ovsdb_idl_index *fdb_by_dp_key,
-                     struct aging_context *ctx)
+fdb_age_threshold_parse(const char *opt, struct threshold_config *config)
 {
-    if (!ctx->threshold) {
-        return;
-    }
+    unsigned int threshold;
 
-    struct sbrec_fdb *fdb_index_row = sbrec_fdb_index_init_row(fdb_by_dp_key);
-    sbrec_fdb_index_set_dp_key(fdb_index_row, dp->tunnel_key);
+    memset(config, 0, sizeof *config);
+    if (opt && str_to_uint(opt, 10, &threshold)) {
+        config->default_threshold = threshold;
+    }
+}
 
+static void
+fdb_aging_handle_tracked(struct aging_index *index,
+                         const struct sbrec_fdb_table *table)
+{
     const struct sbrec_fdb *fdb;
-    SBREC_FDB_FOR_EACH_EQUAL (fdb, fdb_index_row, fdb_by_dp_key) {
-        if (aging_context_handle_timestamp(ctx, fdb->timestamp, NULL)) {
-            sbrec_fdb_delete(fdb);
-            if (aging_context_is_at_limit(ctx)) {
-                break;
-            }
+
+    SBREC_FDB_TABLE_FOR_EACH_TRACKED (fdb, table) {
+        if (sbrec_fdb_is_deleted(fdb)) {
+            aging_index_remove(index, &fdb->header_.uuid);
+        } else {
+            aging_index_update(index, &fdb->header_.uuid, fdb->dp_key,
+                               fdb->timestamp, NULL);
         }
     }
-    sbrec_fdb_index_destroy_row(fdb_index_row);
+}
+
+static void
+fdb_delete(const void *table, const struct uuid *uuid)
+{
+    const struct sbrec_fdb *fdb = sbrec_fdb_table_get_for_uuid(table, uuid);
+    if (fdb) {
+        sbrec_fdb_delete(fdb);
+    }
 }
 
 enum engine_node_state
-en_fdb_aging_run(struct engine_node *node, void *data OVS_UNUSED)
+en_fdb_aging_run(struct engine_node *node, void *data)
 {
     struct northd_data *northd_data = engine_get_input_data("northd", node);
     struct aging_waker *waker = engine_get_input_data("fdb_aging_waker", node);
     struct ed_type_global_config *global_config =
         engine_get_input_data("global_config", node);
+    const struct sbrec_fdb_table *sbrec_fdb_table =
+        EN_OVSDB_GET(engine_get_input("SB_fdb", node));
+    struct aging_index *index = data;
 
-    if (!global_config->features.fdb_timestamp ||
-        time_msec() < waker->next_wake_msec) {
+    if (!global_config->features.fdb_timestamp) {
+        aging_index_clear(index);
         return EN_STALE;
     }
 
-    uint32_t limit = get_removal_limit(node, "fdb_removal_limit");
-    struct aging_context ctx = aging_context_init(limit);
+    const struct hmap *ls_datapaths = &northd_data->ls_datapaths.datapaths;
+    if (!index->valid || engine_get_force_recompute()
+        || aging_index_datapaths_changed(index, ls_datapaths,
+                                         fdb_age_threshold_opt)) {
+        aging_index_reset(index, ls_datapaths, fdb_age_threshold_opt,
+                          fdb_age_threshold_parse);
+
+        const struct sbrec_fdb *fdb;
+        SBREC_FDB_TABLE_FOR_EACH (fdb, sbrec_fdb_table) {
+            aging_index_update(index, &fdb->header_.uuid, fdb->dp_key,
+                               fdb->timestamp, NULL);
+        }
+    } else {
+        /* A failed change handler for another input may have skipped ours
+         * in this iteration. */
+        fdb_aging_handle_tracked(index, sbrec_fdb_table);
+    }
 
-    struct ovsdb_idl_index *sbrec_fdb_by_dp_key =
-            engine_ovsdb_node_get_index(engine_get_input("SB_fdb", node),
-                                        "fdb_by_dp_key");
+    if (time_msec() < waker->next_wake_msec) {
+        aging_waker_schedule_for_index(waker, index);
+        return EN_STALE;
+    }
 
-    struct ovn_datapath *od;
-    HMAP_FOR_EACH (od, key_node, &northd_data->ls_datapaths.datapaths) {
-        ovs_assert(od->nbs);
+    uint32_t limit = get_removal_limit(node, "fdb_removal_limit");
+    int64_t next_wake_ms = aging_index_run(index, limit, fdb_delete,
+                                           sbrec_fdb_table);
+    aging_waker_schedule_next_wake(waker, next_wake_ms);
 
-        if (!od->sdp->sb_dp) {
-            continue;
-        }
+    return EN_UPDATED;
+}
 
-        struct threshold_config threshold_config;
-        memset(&threshold_config, 0, sizeof threshold_config);
-        threshold_config.default_threshold =
-            smap_get_uint(&od->nbs->other_config, "fdb_age_threshold", 0);
-        aging_context_set_threshold(&ctx, &threshold_config);
-        fdb_run_for_datapath(od->sdp->sb_dp, sbrec_fdb_by_dp_key, &ctx);
+enum engine_input_handler_result
+fdb_aging_sb_fdb_handler(struct engine_node *node, void *data)
+{
+    struct aging_index *index = data;
 
-        if (aging_context_is_at_limit(&ctx)) {
-            /* Schedule the next run after specified delay. */
-            ctx.next_wake_ms = AGING_BULK_REMOVAL_DELAY_MSEC;
-            break;
-        }
+    if (!index->valid) {
+        /* The next run builds the index from scratch. */
+        return EN_HANDLED_UNCHANGED;
     }
 
-    aging_waker_schedule_next_wake(waker, ctx.next_wake_ms);
+    const struct sbrec_fdb_table *sbrec_fdb_table =
+        EN_OVSDB_GET(engine_get_input("SB_fdb", node));
+    struct aging_waker *waker = engine_get_input_data("fdb_aging_waker", node);
 
-    return EN_UPDATED;
+    fdb_aging_handle_tracked(index, sbrec_fdb_table);
+    aging_waker_schedule_for_index(waker, index);
+
+    return EN_HANDLED_UNCHANGED;
+}
+
+enum engine_input_handler_result
+fdb_aging_northd_handler(struct engine_node *node, void *data)
+{
+    struct northd_data *northd_data = engine_get_input_data("northd", node);
+    struct aging_index *index = data;
+
+    if (index->valid
+        && aging_index_datapaths_changed(index,
+                                         &northd_data->ls_datapaths.datapaths,
+                                         fdb_age_threshold_opt)) {
+        return EN_UNHANDLED;
+    }
+    return EN_HANDLED_UNCHANGED;
 }
 
 void *
 en_fdb_aging_init(struct engine_node *node OVS_UNUSED,
                   struct engine_arg *arg OVS_UNUSED)
 {
-    return NULL;
+    return aging_index_create();
 }
 
 void
-en_fdb_aging_cleanup(void *data OVS_UNUSED)
+en_fdb_aging_cleanup(void *data)
 {
+    aging_index_destroy(data);
 }
 
 /* The waker node is an input node, but the data about when to wake up
@@ -24,6 +24,10 @@ enum engine_node_state en_mac_binding_aging_run(struct engine_node *node,
 void *en_mac_binding_aging_init(struct engine_node *node,
                                 struct engine_arg *arg);
 void en_mac_binding_aging_cleanup(void *data);
+enum engine_input_handler_result
+mac_binding_aging_sb_mac_binding_handler(struct engine_node *node, void *data);
+enum engine_input_handler_result
+mac_binding_aging_northd_handler(struct engine_node *node, void *data);
 
 /* The MAC binding aging waker node functions. */
 enum engine_node_state en_mac_binding_aging_waker_run(struct engine_node *node,
@@ -39,6 +43,10 @@ unsigned int min_mac_binding_age_threshold(const char *opt);
 enum engine_node_state en_fdb_aging_run(struct engine_node *node, void *data);
 void *en_fdb_aging_init(struct engine_node *node, struct engine_arg *arg);
 void en_fdb_aging_cleanup(void *data);
+enum engine_input_handler_result
+fdb_aging_sb_fdb_handler(struct engine_node *node, void *data);
+enum engine_input_handler_result
+fdb_aging_northd_handler(struct engine_node *node, void *data);
 
 /* The FDB aging waker node functions. */
 enum engine_node_state en_fdb_aging_waker_run(struct engine_node *node,
@@ -56,6 +56,10 @@ static const struct sbrec_address_set *sb_address_set_lookup_by_name(
     struct ovsdb_idl_index *, const char *name);
 static void update_sb_addr_set(struct sorted_array *,
                                const struct sbrec_address_set *);
+static void sync_lr_lb_addr_set(struct ovsdb_idl_txn *ovnsb_txn,
+                                struct ovsdb_idl_index *,
+                                const struct ovn_datapath *od,
+                                int addr_family, const struct sset *ips);
 static void build_port_group_address_set(const struct nbrec_port_group *,
                                          struct svec *ipv4_addrs,
                                          struct svec *ipv6_addrs);
@@ -218,6 +222,64 @@ sync_to_sb_addr_set_nb_port_group_handler(struct engine_node *node,
     return EN_HANDLED_UNCHANGED;
 }
 
+enum engine_input_handler_result
+sync_to_sb_addr_set_northd_handler(struct engine_node *node,
+                                   void *data OVS_UNUSED)
+{
+    struct northd_data *northd_data = engine_get_input_data("northd", node);
+    if (!northd_has_tracked_data(&northd_data->trk_data)) {
+        return EN_UNHANDLED;
+    }
+
+    /* This node only uses the router datapaths of en_northd to name the
+     * load balancer VIP address sets.  Created routers and routers with
+     * changed load balancers or NATs are reported by the en_lr_stateful
+     * input.  Deleted routers need their address sets removed, fall back
+     * to a recompute for those. */
+    if (!hmapx_is_empty(&northd_data->trk_data.trk_routers.deleted)) {
+        return EN_UNHANDLED;
+    }
+
+    return EN_HANDLED_UNCHANGED;
+}
+
+enum engine_input_handler_result
+sync_to_sb_addr_set_lr_stateful_handler(struct engine_node *node,
+                                        void *data OVS_UNUSED)
+{
+    struct ed_type_lr_stateful *lr_stateful_data =
+        engine_get_input_data("lr_stateful", node);
+
+    if (!lr_stateful_has_tracked_data(&lr_stateful_data->trk_data)
+        || !hmapx_is_empty(&lr_stateful_data->trk_data.deleted)) {
+        return EN_UNHANDLED;
+    }
+
+    const struct engine_context *eng_ctx = engine_get_context();
+    struct northd_data *northd_data = engine_get_input_data("northd", node);
+    struct ovsdb_idl_index *sbrec_address_set_by_name =
+        engine_ovsdb_node_get_index(
+                engine_get_input("SB_address_set", node),
+                "sbrec_address_set_by_name");
+
+    struct hmapx_node *hmapx_node;
+    HMAPX_FOR_EACH (hmapx_node, &lr_stateful_data->trk_data.crupdated) {
+        const struct lr_stateful_record *lr_stateful_rec = hmapx_node->data;
+        const struct ovn_datapath *od =
+            ovn_datapaths_find_by_index(&northd_data->lr_datapaths,
+                                        lr_stateful_rec->lr_index);
+
+        sync_lr_lb_addr_set(eng_ctx->ovnsb_idl_txn,
+                            sbrec_address_set_by_name, od, AF_INET,
+                            &lr_stateful_rec->lb_ips->ips_v4_reachable);
+        sync_lr_lb_addr_set(eng_ctx->ovnsb_idl_txn,
+                            sbrec_address_set_by_name, od, AF_INET6,
+                            &lr_stateful_rec->lb_ips->ips_v6_reachable);
+    }
+
+    return EN_HANDLED_UNCHANGED;
+}
+
 /* sync_to_sb_lb engine node functions.
  * This engine node syncs the SB load balancers.
  */
@@ -604,6 +666,39 @@ update_sb_addr_set(struct sorted_array *nb_addresses,
     sorted_array_destroy(&sb_addresses);
 }
 
+/* Syncs the load balancer VIP address set of router 'od' for
+ * 'addr_family' with 'ips'.  Like sync_addr_sets(), the address set only
+ * exists in the SB database while 'ips' is not empty. */
+static void
+sync_lr_lb_addr_set(struct ovsdb_idl_txn *ovnsb_txn,
+                    struct ovsdb_idl_index *sbrec_address_set_by_name,
+                    const struct ovn_datapath *od,
+                    int addr_family, const struct sset *ips)
+{
+    char *name = lr_lb_address_set_name(od->tunnel_key, addr_family);
+    const struct sbrec_address_set *sb_addr_set =
+        sb_address_set_lookup_by_name(sbrec_address_set_by_name, name);
+
+    if (sset_is_empty(ips)) {
+        if (sb_addr_set) {
+            sbrec_address_set_delete(sb_addr_set);
+        }
+        free(name);
+        return;
+    }
+
+    struct sorted_array addrs = sorted_array_from_sset(ips);
+    if (!sb_addr_set) {
+        sb_addr_set = sbrec_address_set_insert(ovnsb_txn);
+        sbrec_address_set_set_name(sb_addr_set, name);
+        sbrec_address_set_set_addresses(sb_addr_set, addrs.arr, addrs.n);
+    } else {
+        update_sb_addr_set(&addrs, sb_addr_set);
+    }
+    sorted_array_destroy(&addrs);
+    free(name);
+}
+
 static void
 build_port_group_address_set(const struct nbrec_port_group *nb_port_group,
                              struct svec *ipv4_addrs,
@@ -16,6 +16,10 @@ enum engine_input_handler_result
 sync_to_sb_addr_set_nb_address_set_handler(struct engine_node *, void *data);
 enum engine_input_handler_result
 sync_to_sb_addr_set_nb_port_group_handler(struct engine_node *, void *data);
+enum engine_input_handler_result
+sync_to_sb_addr_set_northd_handler(struct engine_node *, void *data);
+enum engine_input_handler_result
+sync_to_sb_addr_set_lr_stateful_handler(struct engine_node *, void *data);
 
 
 void *en_sync_to_sb_lb_init(struct engine_node *, struct engine_arg *);
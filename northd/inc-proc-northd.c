@@ -276,7 +276,7 @@ void inc_proc_northd_init(struct ovsdb_idl_loop *nb,
      * change the northd engine node state or data.  Hence
      * it is ok to add a noop_handler here.
      * Note: mac_binding_aging engine node depends on SB mac binding
-     * and it results in full recompute for any changes to it.
+     * and keeps its expiration index up to date incrementally.
      * */
     engine_add_input(&en_northd, &en_sb_mac_binding,
                      engine_noop_handler);
@@ -310,14 +310,16 @@ void inc_proc_northd_init(struct ovsdb_idl_loop *nb,
     engine_add_input(&en_ls_arp, &en_lr_nat, ls_arp_lr_nat_handler);
     engine_add_input(&en_ls_arp, &en_northd, ls_arp_northd_handler);
 
-    engine_add_input(&en_mac_binding_aging, &en_sb_mac_binding, NULL);
-    engine_add_input(&en_mac_binding_aging, &en_northd, NULL);
+    engine_add_input(&en_mac_binding_aging, &en_sb_mac_binding,
+                     mac_binding_aging_sb_mac_binding_handler);
+    engine_add_input(&en_mac_binding_aging, &en_northd,
+                     mac_binding_aging_northd_handler);
     engine_add_input(&en_mac_binding_aging, &en_mac_binding_aging_waker, NULL);
     engine_add_input(&en_mac_binding_aging, &en_global_config,
                      node_global_config_handler);
 
-    engine_add_input(&en_fdb_aging, &en_sb_fdb, NULL);
-    engine_add_input(&en_fdb_aging, &en_northd, NULL);
+    engine_add_input(&en_fdb_aging, &en_sb_fdb, fdb_aging_sb_fdb_handler);
+    engine_add_input(&en_fdb_aging, &en_northd, fdb_aging_northd_handler);
     engine_add_input(&en_fdb_aging, &en_fdb_aging_waker, NULL);
     engine_add_input(&en_fdb_aging, &en_global_config,
                      node_global_config_handler);
@@ -426,8 +428,10 @@ void inc_proc_northd_init(struct ovsdb_idl_loop *nb,
     engine_add_input(&en_lflow, &en_ic_learned_svc_monitors,
                      lflow_ic_learned_svc_mons_handler);
 
-    engine_add_input(&en_sync_to_sb_addr_set, &en_northd, NULL);
-    engine_add_input(&en_sync_to_sb_addr_set, &en_lr_stateful, NULL);
+    engine_add_input(&en_sync_to_sb_addr_set, &en_northd,
+                     sync_to_sb_addr_set_northd_handler);
+    engine_add_input(&en_sync_to_sb_addr_set, &en_lr_stateful,
+                     sync_to_sb_addr_set_lr_stateful_handler);
     engine_add_input(&en_sync_to_sb_addr_set, &en_sb_address_set, NULL);
     engine_add_input(&en_sync_to_sb_addr_set, &en_nb_address_set,
                      sync_to_sb_addr_set_nb_address_set_handler);
@@ -42,7 +42,7 @@ static bool dynamic_addresses_check_for_updates(const char *,
     struct dynamic_address_update *);
 
 static void update_unchanged_dynamic_addresses(
-    struct dynamic_address_update *);
+    struct dynamic_address_update *, bool claimed);
 
 static void set_lsp_dynamic_addresses(const char *,
                                       struct ovn_port *);
@@ -84,6 +84,7 @@ void
 destroy_ipam_info(struct ipam_info *info)
 {
     bitmap_free(info->allocated_ipv4s);
+    bitmap_free(info->excluded_ipv4s);
     free(CONST_CAST(char *, info->id));
 }
 
@@ -109,6 +110,27 @@ ipam_insert_ip(struct ipam_info *info, uint32_t ip, bool dynamic)
     return true;
 }
 
+/* Releases 'ip' in 'info'.  Returns true if it was allocated.  The first
+ * address of the subnet and the excluded ones are never released. */
+static bool
+ipam_remove_ip(struct ipam_info *info, uint32_t ip)
+{
+    if (!info->allocated_ipv4s || ip < info->start_ipv4 ||
+        ip >= info->start_ipv4 + info->total_ipv4s) {
+        return false;
+    }
+
+    size_t index = ip - info->start_ipv4;
+    if (!index || !bitmap_is_set(info->allocated_ipv4s, index)
+        || (info->excluded_ipv4s
+            && bitmap_is_set(info->excluded_ipv4s, index))) {
+        return false;
+    }
+    bitmap_set0(info->allocated_ipv4s, index);
+    info->next_free_ipv4 = MIN(info->next_free_ipv4, index);
+    return true;
+}
+
 static void
 ipam_insert_ip_for_datapath(struct ovn_datapath *od, uint32_t ip,
                             bool dynamic)
@@ -127,8 +149,12 @@ ipam_get_unused_ip(struct ipam_info *info)
         return 0;
     }
 
-    size_t new_ip_index = bitmap_scan(info->allocated_ipv4s, 0, 0,
+    /* All addresses below 'next_free_ipv4' are allocated: it is only moved
+     * back when an address is released. */
+    size_t new_ip_index = bitmap_scan(info->allocated_ipv4s, 0,
+                                      info->next_free_ipv4,
                                       info->total_ipv4s - 1);
+    info->next_free_ipv4 = new_ip_index;
     if (new_ip_index == info->total_ipv4s - 1) {
         static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
         VLOG_WARN_RL(&rl, "%s: Subnet address space has been exhausted.",
@@ -139,19 +165,81 @@ ipam_get_unused_ip(struct ipam_info *info)
     return info->start_ipv4 + new_ip_index;
 }
 
-/* MAC address management (macam) table of "struct eth_addr"s, that holds the
- * MAC addresses allocated by the OVN ipam module. */
-static struct hmap macam = HMAP_INITIALIZER(&macam);
-
-struct macam_node {
-    struct hmap_node hmap_node;
-    struct eth_addr mac_addr; /* Allocated MAC address. */
-};
-
+/* MAC address management (macam).
+ *
+ * Only MAC addresses under 'mac_prefix' are managed, so 'macam' is a bitmap
+ * indexed by the 24-bit suffix of the MAC addresses allocated by the OVN ipam
+ * module.  'macam_full' has one bit per word of 'macam', set when all the
+ * bits in that word are set, so that ipam_get_unused_mac() skips over long
+ * runs of allocated addresses quickly.  Both are allocated on first use. */
 #define MAC_ADDR_SPACE 0xffffff
+#define MACAM_N_BITS (MAC_ADDR_SPACE + 1)
+#define MACAM_N_LONGS BITMAP_N_LONGS(MACAM_N_BITS)
+static unsigned long *macam;
+static unsigned long *macam_full;
+
 static struct eth_addr mac_prefix;
 static char mac_prefix_str[18];
 
+static void
+macam_set1(uint32_t suffix)
+{
+    if (!macam) {
+        macam = bitmap_allocate(MACAM_N_BITS);
+        macam_full = bitmap_allocate(MACAM_N_LONGS);
+    }
+
+    size_t word = suffix / BITMAP_ULONG_BITS;
+    bitmap_set1(macam, suffix);
+    if (macam[word] == ~0UL) {
+        bitmap_set1(macam_full, word);
+    }
+}
+
+static void
+macam_set0(uint32_t suffix)
+{
+    if (macam) {
+        bitmap_set0(macam, suffix);
+        bitmap_set0(macam_full, suffix / BITMAP_ULONG_BITS);
+    }
+}
+
+static bool
+macam_is_set(uint32_t suffix)
+{
+    return macam && bitmap_is_set(macam, suffix);
+}
+
+/* Returns the lowest suffix in the range [start, end) that is not allocated,
+ * or 'end' if there is none. */
+static uint32_t
+macam_scan(uint32_t start, uint32_t end)
+{
+    if (!macam) {
+        return MIN(start, end);
+    }
+
+    uint32_t suffix = start;
+    while (suffix < end) {
+        size_t word = suffix / BITMAP_ULONG_BITS;
+
+        if (bitmap_is_set(macam_full, word)) {
+            word = bitmap_scan(macam_full, false, word, MACAM_N_LONGS);
+            suffix = word * BITMAP_ULONG_BITS;
+            continue;
+        }
+
+        unsigned long unused = ~macam[word]
+                               & (~0UL << (suffix % BITMAP_ULONG_BITS));
+        if (unused) {
+            return MIN(word * BITMAP_ULONG_BITS + raw_ctz(unused), end);
+        }
+        suffix = (word + 1) * BITMAP_ULONG_BITS;
+    }
+    return end;
+}
+
 void
 ipam_insert_mac(struct eth_addr *ea, bool check)
 {
@@ -170,44 +258,36 @@ ipam_insert_mac(struct eth_addr *ea, bool check)
         return;
     }
 
-    struct macam_node *new_macam_node = xmalloc(sizeof *new_macam_node);
-    new_macam_node->mac_addr = *ea;
-    hmap_insert(&macam, &new_macam_node->hmap_node, hash_uint64(mac64));
+    macam_set1(mac64 & MAC_ADDR_SPACE);
 }
 
 uint64_t
 ipam_get_unused_mac(ovs_be32 ip)
 {
-    uint32_t mac_addr_suffix, i, base_addr = ntohl(ip) & MAC_ADDR_SPACE;
-    struct eth_addr mac;
-    uint64_t mac64;
-
-    for (i = 0; i < MAC_ADDR_SPACE - 1; i++) {
-        /* The tentative MAC's suffix will be in the interval (1, 0xfffffe). */
-        mac_addr_suffix = ((base_addr + i) % (MAC_ADDR_SPACE - 1)) + 1;
-        mac64 =  eth_addr_to_uint64(mac_prefix) | mac_addr_suffix;
-        eth_addr_from_uint64(mac64, &mac);
-        if (!ipam_is_duplicate_mac(&mac, mac64, false)) {
-            break;
+    uint32_t base_addr = ntohl(ip) & MAC_ADDR_SPACE;
+
+    /* The MAC's suffix will be in the interval [1, 0xfffffe].  Start looking
+     * at the suffix derived from 'ip', then wrap around. */
+    uint32_t start = (base_addr % (MAC_ADDR_SPACE - 1)) + 1;
+    uint32_t suffix = macam_scan(start, MAC_ADDR_SPACE);
+    if (suffix == MAC_ADDR_SPACE) {
+        suffix = macam_scan(1, start);
+        if (suffix == start) {
+            static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
+            VLOG_WARN_RL(&rl, "MAC address space exhausted.");
+            return 0;
         }
     }
 
-    if (i == MAC_ADDR_SPACE) {
-        static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(5, 1);
-        VLOG_WARN_RL(&rl, "MAC address space exhausted.");
-        mac64 = 0;
-    }
-
-    return mac64;
+    return eth_addr_to_uint64(mac_prefix) | suffix;
 }
 
 void
 cleanup_macam(void)
 {
-    struct macam_node *node;
-    HMAP_FOR_EACH_POP (node, hmap_node, &macam) {
-        free(node);
-    }
+    bitmap_free(macam);
+    bitmap_free(macam_full);
+    macam = macam_full = NULL;
 }
 
 struct eth_addr
@@ -302,6 +382,8 @@ init_ipam_ipv4(const char *subnet_str, const char *exclude_ip_list,
     info->start_ipv4 = 0;
     info->total_ipv4s = 0;
     info->allocated_ipv4s = NULL;
+    info->excluded_ipv4s = NULL;
+    info->next_free_ipv4 = 0;
 
     if (!subnet_str) {
         return;
@@ -369,22 +451,25 @@ init_ipam_ipv4(const char *subnet_str, const char *exclude_ip_list,
         VLOG_WARN_RL(&rl, "%s: bad exclude_ips (%s)", info->id, lexer.error);
     }
     lexer_destroy(&lexer);
+
+    /* Nothing else is allocated yet, so these are exactly the addresses that
+     * must never be released. */
+    info->excluded_ipv4s = bitmap_clone(info->allocated_ipv4s,
+                                        info->total_ipv4s);
 }
 
 static bool
 ipam_is_duplicate_mac(struct eth_addr *ea, uint64_t mac64, bool warn)
 {
-    struct macam_node *macam_node;
-    HMAP_FOR_EACH_WITH_HASH (macam_node, hmap_node, hash_uint64(mac64),
-                             &macam) {
-        if (eth_addr_equals(*ea, macam_node->mac_addr)) {
-            if (warn) {
-                static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 1);
-                VLOG_WARN_RL(&rl, "Duplicate MAC set: "ETH_ADDR_FMT,
-                             ETH_ADDR_ARGS(macam_node->mac_addr));
-            }
-            return true;
+    uint64_t prefix = eth_addr_to_uint64(mac_prefix);
+
+    if (!((mac64 ^ prefix) >> 24) && macam_is_set(mac64 & MAC_ADDR_SPACE)) {
+        if (warn) {
+            static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 1);
+            VLOG_WARN_RL(&rl, "Duplicate MAC set: "ETH_ADDR_FMT,
+                         ETH_ADDR_ARGS(*ea));
         }
+        return true;
     }
     return false;
 }
@@ -559,10 +644,12 @@ dynamic_addresses_check_for_updates(const char *lsp_addrs,
 
 /* For addresses that do not need to be updated, go ahead and insert them
  * into IPAM. This way, their addresses will be claimed and cannot be assigned
- * elsewhere later.
+ * elsewhere later.  If 'claimed' is true, the addresses were already inserted
+ * by an earlier run, so finding them allocated is not a conflict.
  */
 static void
-update_unchanged_dynamic_addresses(struct dynamic_address_update *update)
+update_unchanged_dynamic_addresses(struct dynamic_address_update *update,
+                                   bool claimed)
 {
     if (update->mac == NONE) {
         ipam_insert_mac(&update->current_addresses.ea, false);
@@ -570,15 +657,21 @@ update_unchanged_dynamic_addresses(struct dynamic_address_update *update)
     if (update->ipv4 == NONE && update->current_addresses.n_ipv4_addrs) {
         ipam_insert_ip_for_datapath(update->op->od,
                        ntohl(update->current_addresses.ipv4_addrs[0].addr),
-                       true);
+                       !claimed);
     }
 }
 
 static void
 set_lsp_dynamic_addresses(const char *dynamic_addresses, struct ovn_port *op)
 {
+    /* The dynamic address is always the last one in 'lsp_addrs'. */
+    if (op->has_dynamic_lsp_addr) {
+        op->n_lsp_addrs--;
+        destroy_lport_addresses(&op->lsp_addrs[op->n_lsp_addrs]);
+    }
     extract_lsp_addresses(dynamic_addresses, &op->lsp_addrs[op->n_lsp_addrs]);
     op->n_lsp_addrs++;
+    op->has_dynamic_lsp_addr = true;
 }
 
 /* Determines which components (MAC, IPv4, and IPv6) of dynamic
@@ -713,9 +806,90 @@ update_dynamic_addresses(struct dynamic_address_update *update)
 }
 
 
+/* Checks the dynamic addresses requested by logical switch port 'op' of
+ * 'od'.  Addresses that are still valid are claimed in IPAM, and added to
+ * op->lsp_addrs if they are not there yet; the ones that need to be assigned
+ * are queued in 'updates'.  If 'claimed' is true, the port's addresses are
+ * already in IPAM from an earlier run. */
 void
-update_ipam_ls(struct ovn_datapath *od, struct vector *updates,
-               bool recompute)
+update_ipam_lsp(struct ovn_datapath *od, struct ovn_port *op,
+                struct vector *updates, bool claimed)
+{
+    const struct nbrec_logical_switch_port *nbsp = op->nbsp;
+    ovs_assert(nbsp);
+
+    if (!od->ipam_info.allocated_ipv4s &&
+        !od->ipam_info.ipv6_prefix_set &&
+        !od->ipam_info.mac_only) {
+        if (nbsp->dynamic_addresses) {
+            nbrec_logical_switch_port_set_dynamic_addresses(nbsp, NULL);
+        }
+        return;
+    }
+
+    bool has_dynamic_address = false;
+    for (size_t j = 0; j < nbsp->n_addresses; j++) {
+        if (!is_dynamic_lsp_address(nbsp->addresses[j])) {
+            continue;
+        }
+        if (has_dynamic_address) {
+            static struct vlog_rate_limit rl
+                = VLOG_RATE_LIMIT_INIT(1, 1);
+            VLOG_WARN_RL(&rl, "More than one dynamic address "
+                         "configured for logical switch port '%s'",
+                         nbsp->name);
+            continue;
+        }
+        has_dynamic_address = true;
+        struct dynamic_address_update update = {
+            .op = op,
+            .od = od,
+        };
+        init_lport_addresses(&update.current_addresses);
+        if (nbsp->dynamic_addresses) {
+            bool any_changed;
+            extract_lsp_addresses(nbsp->dynamic_addresses,
+                                  &update.current_addresses);
+
+            /* An address claimed earlier by this very port is not a
+             * conflict, so take it out while checking for changes.  It is
+             * put back afterwards even if it is not used anymore, since
+             * IPAM can't tell whether another port holds it too. */
+            uint32_t own_ip = 0;
+            if (claimed && update.current_addresses.n_ipv4_addrs) {
+                own_ip = ntohl(update.current_addresses.ipv4_addrs[0].addr);
+                if (!ipam_remove_ip(&od->ipam_info, own_ip)) {
+                    own_ip = 0;
+                }
+            }
+            any_changed = dynamic_addresses_check_for_updates(
+                nbsp->addresses[j], &update);
+            if (own_ip) {
+                ipam_insert_ip(&od->ipam_info, own_ip, false);
+            }
+            update_unchanged_dynamic_addresses(&update, claimed);
+            if (any_changed) {
+                vector_push(updates, &update);
+            } else {
+                /* No changes to dynamic addresses */
+                if (!op->has_dynamic_lsp_addr) {
+                    set_lsp_dynamic_addresses(nbsp->dynamic_addresses, op);
+                }
+                destroy_lport_addresses(&update.current_addresses);
+            }
+        } else {
+            set_dynamic_updates(nbsp->addresses[j], &update);
+            vector_push(updates, &update);
+        }
+    }
+
+    if (!has_dynamic_address && nbsp->dynamic_addresses) {
+        nbrec_logical_switch_port_set_dynamic_addresses(nbsp, NULL);
+    }
+}
+
+void
+update_ipam_ls(struct ovn_datapath *od, struct vector *updates)
 {
     ovs_assert(od);
     ovs_assert(od->nbs);
@@ -723,62 +897,102 @@ update_ipam_ls(struct ovn_datapath *od, struct vector *updates,
 
     struct ovn_port *op;
     HMAP_FOR_EACH (op, dp_node, &od->ports) {
-        const struct nbrec_logical_switch_port *nbsp = op->nbsp;
-        ovs_assert(nbsp);
-
-        if (!od->ipam_info.allocated_ipv4s &&
-            !od->ipam_info.ipv6_prefix_set &&
-            !od->ipam_info.mac_only) {
-            if (nbsp->dynamic_addresses) {
-                nbrec_logical_switch_port_set_dynamic_addresses(nbsp,
-                                                                NULL);
-            }
+        update_ipam_lsp(od, op, updates, false);
+    }
+}
+
+/* Returns true if a port of 'od' other than 'op', or a router port attached
+ * to 'od', uses MAC address 'ea'. */
+static bool
+ipam_mac_in_use(const struct ovn_datapath *od, const struct ovn_port *op,
+                const struct eth_addr ea)
+{
+    const struct ovn_port *other;
+    HMAP_FOR_EACH (other, dp_node, &od->ports) {
+        if (other == op) {
             continue;
         }
-
-        bool has_dynamic_address = false;
-        for (size_t j = 0; j < nbsp->n_addresses; j++) {
-            if (!is_dynamic_lsp_address(nbsp->addresses[j])) {
-                continue;
+        for (size_t i = 0; i < other->n_lsp_addrs; i++) {
+            if (eth_addr_equals(other->lsp_addrs[i].ea, ea)) {
+                return true;
             }
-            if (has_dynamic_address) {
-                static struct vlog_rate_limit rl
-                    = VLOG_RATE_LIMIT_INIT(1, 1);
-                VLOG_WARN_RL(&rl, "More than one dynamic address "
-                             "configured for logical switch port '%s'",
-                             nbsp->name);
-                continue;
-            }
-            has_dynamic_address = true;
-            struct dynamic_address_update update = {
-                .op = op,
-                .od = od,
-            };
-            init_lport_addresses(&update.current_addresses);
-            if (nbsp->dynamic_addresses) {
-                bool any_changed;
-                extract_lsp_addresses(nbsp->dynamic_addresses,
-                                      &update.current_addresses);
-                any_changed = dynamic_addresses_check_for_updates(
-                    nbsp->addresses[j], &update);
-                update_unchanged_dynamic_addresses(&update);
-                if (any_changed) {
-                    vector_push(updates, &update);
-                } else {
-                    /* No changes to dynamic addresses */
-                    if (recompute) {
-                        set_lsp_dynamic_addresses(nbsp->dynamic_addresses, op);
-                    }
-                    destroy_lport_addresses(&update.current_addresses);
+        }
+        if (other->peer && other->peer->nbrp
+            && eth_addr_equals(other->peer->lrp_networks.ea, ea)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Returns true if a port of 'od' other than 'op', or a router port attached
+ * to 'od', uses IPv4 address 'ip'. */
+static bool
+ipam_ip_in_use(const struct ovn_datapath *od, const struct ovn_port *op,
+               ovs_be32 ip)
+{
+    const struct ovn_port *other;
+    HMAP_FOR_EACH (other, dp_node, &od->ports) {
+        if (other == op) {
+            continue;
+        }
+        for (size_t i = 0; i < other->n_lsp_addrs; i++) {
+            const struct lport_addresses *laddrs = &other->lsp_addrs[i];
+            for (size_t j = 0; j < laddrs->n_ipv4_addrs; j++) {
+                if (laddrs->ipv4_addrs[j].addr == ip) {
+                    return true;
                 }
-            } else {
-                set_dynamic_updates(nbsp->addresses[j], &update);
-                vector_push(updates, &update);
             }
         }
+        if (!other->peer || !other->peer->nbrp) {
+            continue;
+        }
+        const struct lport_addresses *networks =
+            &other->peer->lrp_networks;
+        for (size_t i = 0; i < networks->n_ipv4_addrs; i++) {
+            if (networks->ipv4_addrs[i].addr == ip) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
 
-        if (!has_dynamic_address && nbsp->dynamic_addresses) {
-            nbrec_logical_switch_port_set_dynamic_addresses(nbsp, NULL);
+/* Releases the MAC and IPv4 addresses that logical switch port 'op' of 'od'
+ * holds in IPAM, both its static ones and its dynamic one, because 'op' is
+ * being deleted or its addresses are about to change.  IPAM does not keep
+ * track of who owns an address, so an address is only released if no other
+ * port of 'od' uses it too.  MACs are global, but a static MAC under the
+ * MAC prefix shared with a port of another switch is not worth a walk over
+ * all ports. */
+void
+ipam_release_port_addresses(struct ovn_datapath *od,
+                            const struct ovn_port *op)
+{
+    uint64_t prefix = eth_addr_to_uint64(mac_prefix);
+
+    for (size_t i = 0; i < op->n_lsp_addrs; i++) {
+        if (i >= op->n_lsp_non_router_addrs
+            && !(op->has_dynamic_lsp_addr && i == op->n_lsp_addrs - 1)) {
+            continue;
+        }
+
+        const struct lport_addresses *laddrs = &op->lsp_addrs[i];
+        uint64_t mac64 = eth_addr_to_uint64(laddrs->ea);
+        if (!((mac64 ^ prefix) >> 24)
+            && macam_is_set(mac64 & MAC_ADDR_SPACE)
+            && !ipam_mac_in_use(od, op, laddrs->ea)) {
+            macam_set0(mac64 & MAC_ADDR_SPACE);
+        }
+
+        if (!od->ipam_info.allocated_ipv4s) {
+            continue;
+        }
+        for (size_t j = 0; j < laddrs->n_ipv4_addrs; j++) {
+            ovs_be32 ip = laddrs->ipv4_addrs[j].addr;
+            if (!ipam_ip_in_use(od, op, ip)) {
+                ipam_remove_ip(&od->ipam_info, ntohl(ip));
+            }
         }
     }
 }
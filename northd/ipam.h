@@ -12,6 +12,8 @@ struct ipam_info {
     uint32_t start_ipv4;
     size_t total_ipv4s;
     unsigned long *allocated_ipv4s; /* A bitmap of allocated IPv4s */
+    unsigned long *excluded_ipv4s;  /* IPv4s reserved at init, never freed. */
+    size_t next_free_ipv4;  /* All IPv4s below this index are allocated. */
     bool ipv6_prefix_set;
     struct in6_addr ipv6_prefix;
     bool mac_only;
@@ -65,7 +67,13 @@ struct eth_addr get_mac_prefix(void);
 
 const char *set_mac_prefix(const char *hint);
 
-void update_ipam_ls(struct ovn_datapath *, struct vector *, bool);
+void update_ipam_lsp(struct ovn_datapath *, struct ovn_port *,
+                     struct vector *, bool claimed);
+
+void update_ipam_ls(struct ovn_datapath *, struct vector *);
+
+void ipam_release_port_addresses(struct ovn_datapath *,
+                                 const struct ovn_port *);
 
 void update_dynamic_addresses(struct dynamic_address_update *);
 
@@ -19,6 +19,7 @@
 /* OVS includes */
 #include "include/openvswitch/thread.h"
 #include "lib/bitmap.h"
+#include "openvswitch/util.h"
 #include "openvswitch/vlog.h"
 
 /* OVN includes */
@@ -128,9 +129,17 @@ static bool lflow_hash_lock_initialized = false;
  * mutex array is used instead of 1-1 mapping to the hash buckets. This
  * simplies the implementation while effectively reduces lock contention
  * because the chance that different threads contending the same lock amongst
- * the big number of locks is very low. */
+ * the big number of locks is very low.
+ *
+ * Each mutex is padded to a full cache line.  Otherwise neighbouring mutexes
+ * share a cache line and threads that take unrelated locks still bounce the
+ * line between cores, which shows up as contention as the number of threads
+ * grows. */
 #define LFLOW_HASH_LOCK_MASK 0xFFFF
-static struct ovs_mutex lflow_hash_locks[LFLOW_HASH_LOCK_MASK + 1];
+struct lflow_hash_lock {
+    PADDED_MEMBERS(CACHE_LINE_SIZE, struct ovs_mutex mutex;);
+};
+static struct lflow_hash_lock lflow_hash_locks[LFLOW_HASH_LOCK_MASK + 1];
 
 /* Full thread safety analysis is not possible with hash locks, because
  * they are taken conditionally based on the 'parallelization_state' and
@@ -271,8 +280,16 @@ lflow_table_sync_to_sb(struct lflow_table *lflow_table,
     struct ovn_lflow *lflow;
     const struct sbrec_logical_flow *sbflow;
 
-    fast_hmap_size_for(&lflows_temp,
-                       lflow_table->max_seen_lflow_size);
+    /* When searching by field the lflows that matched an SB flow are moved
+     * to 'lflows_temp', so that the ones left in 'lflows' are the ones to
+     * insert.  Every lflow already knows its SB flow when searching by
+     * SB uuid, so the table is synced in place instead of being relinked
+     * into a new hmap on every recompute. */
+    bool search_by_fields = search_mode == LFLOW_TABLE_SEARCH_FIELDS;
+    if (search_by_fields) {
+        fast_hmap_size_for(&lflows_temp,
+                           lflow_table->max_seen_lflow_size);
+    }
 
     HMAP_FOR_EACH_SAFE (lflow, hmap_node, lflows) {
         if (search_mode != LFLOW_TABLE_SEARCH_SBUUID) {
@@ -300,9 +317,6 @@ lflow_table_sync_to_sb(struct lflow_table *lflow_table,
                          ovn_internal_version_changed,
                          sbflow, dpgrp_table);
         uuidset_insert(&sb_uuid_set, &lflow->sb_uuid);
-        hmap_remove(lflows, &lflow->hmap_node);
-        hmap_insert(&lflows_temp, &lflow->hmap_node,
-                    hmap_node_hash(&lflow->hmap_node));
     }
     /* Push changes to the Logical_Flow table to database. */
     SBREC_LOGICAL_FLOW_TABLE_FOR_EACH_SAFE (sbflow, sb_flow_table) {
@@ -402,7 +416,9 @@ lflow_table_sync_to_sb(struct lflow_table *lflow_table,
     }
     search_mode = LFLOW_TABLE_SEARCH_SBUUID;
     uuidset_destroy(&sb_uuid_set);
-    hmap_swap(lflows, &lflows_temp);
+    if (search_by_fields) {
+        hmap_swap(lflows, &lflows_temp);
+    }
     hmap_destroy(&lflows_temp);
 }
 
@@ -823,10 +839,8 @@ ovn_dp_group_get(struct hmap *dp_groups,
                  const struct dynamic_bitmap *desired_bitmap,
                  size_t bitmap_len)
 {
-    uint32_t hash;
-
-    hash = hash_int(desired_bitmap->n_elems, 0);
-    return ovn_dp_group_find(dp_groups, desired_bitmap, bitmap_len, hash);
+    return ovn_dp_group_find(dp_groups, desired_bitmap, bitmap_len,
+                             dynamic_bitmap_hash(desired_bitmap));
 }
 
 /* Creates a new datapath group and adds it to 'dp_groups'.
@@ -867,7 +881,7 @@ ovn_dp_group_create(struct ovsdb_idl_txn *ovnsb_txn,
         /* We can modify existing group if it's not already in use. */
         can_modify = !ovn_dp_group_find(dp_groups, &dpg_bitmap,
                                         desired_bitmap->capacity,
-                                        hash_int(dpg_bitmap.n_elems, 0));
+                                        dynamic_bitmap_hash(&dpg_bitmap));
     }
 
     dynamic_bitmap_free(&dpg_bitmap);
@@ -883,7 +897,7 @@ ovn_dp_group_create(struct ovsdb_idl_txn *ovnsb_txn,
                             desired_bitmap, datapaths);
     }
     dpg->dpg_uuid = dpg->dp_group->header_.uuid;
-    hmap_insert(dp_groups, &dpg->node, hash_int(desired_bitmap->n_elems, 0));
+    hmap_insert(dp_groups, &dpg->node, dynamic_bitmap_hash(desired_bitmap));
 
     return dpg;
 }
@@ -909,7 +923,7 @@ lflow_hash_lock_init(void)
 {
     if (!lflow_hash_lock_initialized) {
         for (size_t i = 0; i < LFLOW_HASH_LOCK_MASK + 1; i++) {
-            ovs_mutex_init(&lflow_hash_locks[i]);
+            ovs_mutex_init(&lflow_hash_locks[i].mutex);
         }
         lflow_hash_lock_initialized = true;
     }
@@ -920,7 +934,7 @@ lflow_hash_lock_destroy(void)
 {
     if (lflow_hash_lock_initialized) {
         for (size_t i = 0; i < LFLOW_HASH_LOCK_MASK + 1; i++) {
-            ovs_mutex_destroy(&lflow_hash_locks[i]);
+            ovs_mutex_destroy(&lflow_hash_locks[i].mutex);
         }
     }
     lflow_hash_lock_initialized = false;
@@ -961,8 +975,8 @@ lflow_hash_lock(const struct hmap *lflow_table, uint32_t hash)
     struct ovs_mutex *hash_lock = NULL;
 
     if (parallelization_state == STATE_USE_PARALLELIZATION) {
-        hash_lock =
-            &lflow_hash_locks[hash & lflow_table->mask & LFLOW_HASH_LOCK_MASK];
+        hash_lock = &lflow_hash_locks[hash & lflow_table->mask
+                                      & LFLOW_HASH_LOCK_MASK].mutex;
         ovs_mutex_lock(hash_lock);
     }
     return hash_lock;
@@ -1195,11 +1209,21 @@ sync_lflow_to_sb(struct ovn_lflow *lflow,
         }
     }
 
+    /* The setters below build a new datum for the column even when the row
+     * already has the same value, so skip them for rows that are up to date,
+     * which is the common case when resyncing with an existing SB DB. */
     if (lflow->dp) {
-        sbrec_logical_flow_set_logical_datapath(sbflow, lflow->dp->sb_dp);
-        sbrec_logical_flow_set_logical_dp_group(sbflow, NULL);
+        if (sbflow->logical_datapath != lflow->dp->sb_dp) {
+            sbrec_logical_flow_set_logical_datapath(sbflow,
+                                                    lflow->dp->sb_dp);
+        }
+        if (sbflow->logical_dp_group) {
+            sbrec_logical_flow_set_logical_dp_group(sbflow, NULL);
+        }
     } else {
-        sbrec_logical_flow_set_logical_datapath(sbflow, NULL);
+        if (sbflow->logical_datapath) {
+            sbrec_logical_flow_set_logical_datapath(sbflow, NULL);
+        }
         lflow->dpg = ovn_dp_group_get(dp_groups, &lflow->dpg_bitmap,
                                       n_datapaths);
         if (lflow->dpg) {
@@ -1236,8 +1260,10 @@ sync_lflow_to_sb(struct ovn_lflow *lflow,
                                 &lflow->dpg_bitmap,
                                 datapaths);
         }
-        sbrec_logical_flow_set_logical_dp_group(sbflow,
-                                                lflow->dpg->dp_group);
+        if (sbflow->logical_dp_group != lflow->dpg->dp_group) {
+            sbrec_logical_flow_set_logical_dp_group(sbflow,
+                                                    lflow->dpg->dp_group);
+        }
     }
 
     if (pre_sync_dpg != lflow->dpg) {
@@ -1105,6 +1105,7 @@ ovn_port_cleanup(struct ovn_port *port)
     free(port->lsp_addrs);
     port->n_lsp_addrs = 0;
     port->lsp_addrs = NULL;
+    port->has_dynamic_lsp_addr = false;
 
     if (port->peer) {
         port->peer->peer = NULL;
@@ -1357,7 +1358,7 @@ build_ipam(struct hmap *ls_datapaths)
      * ports that have the "dynamic" keyword in their addresses column. */
     struct ovn_datapath *od;
     HMAP_FOR_EACH (od, key_node, ls_datapaths) {
-        update_ipam_ls(od, &updates, true);
+        update_ipam_ls(od, &updates);
     }
     /* After retaining all unchanged dynamic addresses, now assign
      * new ones.
@@ -4400,11 +4401,6 @@ lsp_can_be_inc_processed(const struct nbrec_logical_switch_port *nbsp)
     }
 
     for (size_t j = 0; j < nbsp->n_addresses; j++) {
-        /* Dynamic address was assigned in the last iteration. */
-        if (is_dynamic_lsp_address(nbsp->addresses[j]) &&
-            nbsp->dynamic_addresses) {
-            return false;
-        }
         /* "unknown" address handling is not supported for now.  XXX: Need to
          * handle od->has_unknown change and track it when the first LSP with
          * 'unknown' is added or when the last one is removed. */
@@ -4423,6 +4419,13 @@ lsp_can_be_inc_processed(const struct nbrec_logical_switch_port *nbsp)
     return true;
 }
 
+static bool
+ls_has_ipam(const struct ovn_datapath *od)
+{
+    return od->ipam_info.allocated_ipv4s || od->ipam_info.ipv6_prefix_set
+           || od->ipam_info.mac_only;
+}
+
 static bool
 ls_port_has_changed(const struct nbrec_logical_switch_port *new)
 {
@@ -4742,6 +4745,12 @@ ls_handle_lsp_changes(struct ovsdb_idl_txn *ovnsb_idl_txn,
                     continue;
                 }
 
+                if (ls_has_ipam(od) && nbrec_logical_switch_port_is_updated(
+                        new_nbsp, NBREC_LOGICAL_SWITCH_PORT_COL_ADDRESSES)) {
+                    /* The old addresses are gone after ls_port_reinit(). */
+                    ipam_release_port_addresses(od, op);
+                }
+
                 uint32_t old_tunnel_key = op->tunnel_key;
                 if (!ls_port_reinit(op, ovnsb_idl_txn,
                                     new_nbsp,
@@ -4913,6 +4922,9 @@ northd_handle_ls_changes(struct ovsdb_idl_txn *ovnsb_idl_txn,
 
         ods_assign_array_index(&nd->ls_datapaths, od);
         init_ipam_info_for_datapath(od);
+        if (ls_has_ipam(od)) {
+            hmapx_add(&trk_data->ls_with_changed_ipam, od);
+        }
         init_mcast_info_for_datapath(od);
 
         /* Create SB:IP_Multicast for the logical switch. */
@@ -4960,10 +4972,7 @@ northd_handle_ls_changes(struct ovsdb_idl_txn *ovnsb_idl_txn,
             hmapx_add(&trk_data->ls_with_changed_acls, od);
         }
         init_ipam_info_for_datapath(od);
-        bool ls_has_ipam = od->ipam_info.allocated_ipv4s ||
-                           od->ipam_info.ipv6_prefix_set ||
-                           od->ipam_info.mac_only;
-        if (ls_has_ipam) {
+        if (ls_has_ipam(od)) {
             hmapx_add(&trk_data->ls_with_changed_ipam, od);
         }
     }
@@ -5093,9 +5102,26 @@ fail:
     return false;
 }
 
+/* Assigns dynamic addresses to the tracked logical switch ports of the
+ * switches in 'ls_with_changed_ipam'.  IPAM state is kept across runs, so
+ * only the tracked ports need to be looked at.  The addresses of deleted
+ * ports are released here, the old ones of ports whose addresses changed
+ * were released by ls_handle_lsp_changes() before the port was reinitialized.
+ *
+ * Returns true if any port's addresses were updated. */
 bool northd_handle_ipam_changes(struct northd_data *nd)
 {
     struct northd_tracked_data *nd_changes = &nd->trk_data;
+    struct hmapx_node *hmapx_node;
+    struct ovn_port *op;
+
+    HMAPX_FOR_EACH (hmapx_node, &nd_changes->trk_lsps.deleted) {
+        op = hmapx_node->data;
+        if (op->nbsp && ls_has_ipam(op->od)) {
+            ipam_release_port_addresses(op->od, op);
+        }
+    }
+
     if (hmapx_is_empty(&nd_changes->ls_with_changed_ipam)) {
         return false;
     }
@@ -5103,25 +5129,31 @@ bool northd_handle_ipam_changes(struct northd_data *nd)
     struct vector updates =
         VECTOR_EMPTY_INITIALIZER(struct dynamic_address_update);
 
-    struct hmapx_node *hmapx_node;
-    HMAPX_FOR_EACH (hmapx_node, &nd_changes->ls_with_changed_ipam) {
-        struct ovn_datapath *od = hmapx_node->data;
-        if (od->ipam_info_initialized) {
-            destroy_ipam_info(&od->ipam_info);
-            od->ipam_info_initialized = false;
+    HMAPX_FOR_EACH (hmapx_node, &nd_changes->trk_lsps.created) {
+        op = hmapx_node->data;
+        if (hmapx_find(&nd_changes->ls_with_changed_ipam, op->od)) {
+            ipam_add_port_addresses(op->od, op);
+            update_ipam_lsp(op->od, op, &updates, false);
         }
-        init_ipam_info_for_datapath(od);
-        update_ipam_ls(od, &updates, false);
+    }
+    HMAPX_FOR_EACH (hmapx_node, &nd_changes->trk_lsps.updated) {
+        op = hmapx_node->data;
+        if (!op->nbsp ||
+            !hmapx_find(&nd_changes->ls_with_changed_ipam, op->od)) {
+            continue;
+        }
+        if (nbrec_logical_switch_port_is_updated(
+                op->nbsp, NBREC_LOGICAL_SWITCH_PORT_COL_ADDRESSES)) {
+            ipam_add_port_addresses(op->od, op);
+        }
+        update_ipam_lsp(op->od, op, &updates, true);
     }
 
     bool lsps_changed = false;
     struct dynamic_address_update *update;
     VECTOR_FOR_EACH_PTR (&updates, update) {
-        if (hmapx_find(&nd_changes->trk_lsps.updated, update->op) ||
-            hmapx_find(&nd_changes->trk_lsps.created, update->op)) {
-            update_dynamic_addresses(update);
-            lsps_changed = true;
-        }
+        update_dynamic_addresses(update);
+        lsps_changed = true;
         destroy_lport_addresses(&update->current_addresses);
     }
     vector_destroy(&updates);
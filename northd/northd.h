@@ -725,6 +725,8 @@ struct ovn_port {
     unsigned int n_lsp_non_router_addrs; /* Number of elements from the
                                           * beginning of 'lsp_addrs' extracted
                                           * directly from LSP 'addresses'. */
+    bool has_dynamic_lsp_addr; /* True if the last element of 'lsp_addrs'
+                                * holds the port's 'dynamic_addresses'. */
 
     struct lport_addresses *ps_addrs;   /* Port security addresses. */
     unsigned int n_ps_addrs;
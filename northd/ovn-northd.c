@@ -40,6 +40,7 @@
 #include "lib/stopwatch-names.h"
 #include "stream.h"
 #include "stream-ssl.h"
+#include "timeval.h"
 #include "unixctl.h"
 #include "util.h"
 #include "openvswitch/vlog.h"
@@ -60,8 +61,20 @@ static unixctl_cb_func ovn_northd_get_thread_count_cmd;
 struct northd_state {
     bool had_lock;
     bool paused;
+
+    /* Time at which the SB transaction that is currently in flight was
+     * sent to the database, or 0 if no SB transaction is in flight. */
+    long long int sb_commit_start_ms;
+
+    /* Time at which this instance acquired the SB lock, until the first
+     * engine run after that completes, 0 otherwise. */
+    long long int takeover_start_ms;
 };
 
+/* SB transactions that take longer than this (in ms) to complete are
+ * logged. */
+#define SB_COMMIT_SLOW_MS 1000
+
 #define OVN_MAX_SUPPORTED_THREADS 256
 
 static const char *ovnnb_db;
@@ -817,6 +830,35 @@ sb_cfg_is_in_sync(struct ovsdb_idl *ovnnb_idl,
     return !(nb && sb_loop->cur_cfg && nb->sb_cfg != sb_loop->cur_cfg);
 }
 
+/* Tracks the SB transaction in flight in 'sb_loop', so that "status" can
+ * report a long running commit, and logs commits that were slow to
+ * complete.
+ *
+ * Must be called both after ovsdb_idl_loop_run(), which retires a completed
+ * commit, and after ovsdb_idl_loop_commit_and_wait(), which may send the
+ * next one. */
+static void
+update_sb_commit_state(struct northd_state *state,
+                       const struct ovsdb_idl_loop *sb_loop)
+{
+    if (sb_loop->committing_txn) {
+        if (!state->sb_commit_start_ms) {
+            state->sb_commit_start_ms = time_msec();
+        }
+        return;
+    }
+
+    if (state->sb_commit_start_ms) {
+        long long int duration = time_msec() - state->sb_commit_start_ms;
+        if (duration >= SB_COMMIT_SLOW_MS) {
+            static struct vlog_rate_limit rl = VLOG_RATE_LIMIT_INIT(1, 5);
+            VLOG_INFO_RL(&rl, "OVNSB commit took %lld ms to complete.",
+                         duration);
+        }
+        state->sb_commit_start_ms = 0;
+    }
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -827,7 +869,9 @@ main(int argc, char *argv[])
     int n_threads = 1;
     struct northd_state state = {
         .had_lock = false,
-        .paused = false
+        .paused = false,
+        .sb_commit_start_ms = 0,
+        .takeover_start_ms = 0,
     };
 
     fatal_ignore_sigpipe();
@@ -1053,6 +1097,10 @@ main(int argc, char *argv[])
             struct ovsdb_idl_txn *ovnsb_txn =
                     run_idl_loop(&ovnsb_idl_loop, "OVN_Southbound",
                                  &eng_ctx.sb_idl_duration_ms);
+            /* Close out the SB commit that has just completed, if any, before
+             * the next one is sent, so that back to back commits are timed
+             * separately. */
+            update_sb_commit_state(&state, &ovnsb_idl_loop);
             unsigned int new_ovnsb_cond_seqno =
                         ovsdb_idl_get_condition_seqno(ovnsb_idl_loop.idl);
             if (new_ovnsb_cond_seqno != ovnsb_cond_seqno) {
@@ -1067,6 +1115,7 @@ main(int argc, char *argv[])
                 VLOG_INFO("ovn-northd lock acquired. "
                         "This ovn-northd instance is now active.");
                 state.had_lock = true;
+                state.takeover_start_ms = time_msec();
                 search_mode = LFLOW_TABLE_SEARCH_FIELDS;
             } else if (state.had_lock &&
                        !ovsdb_idl_has_lock(ovnsb_idl_loop.idl))
@@ -1074,6 +1123,7 @@ main(int argc, char *argv[])
                 VLOG_INFO("ovn-northd lock lost. "
                         "This ovn-northd instance is now on standby.");
                 state.had_lock = false;
+                state.takeover_start_ms = 0;
                 search_mode = LFLOW_TABLE_SEARCH_FIELDS;
             }
 
@@ -1088,6 +1138,12 @@ main(int argc, char *argv[])
                         activity = inc_proc_northd_run(ovnnb_txn,
                                                        ovnsb_txn,
                                                        &eng_ctx);
+                        if (activity && state.takeover_start_ms) {
+                            VLOG_INFO("Initial recompute after acquiring "
+                                      "the lock took %lld ms.",
+                                      time_msec() - state.takeover_start_ms);
+                            state.takeover_start_ms = 0;
+                        }
                     } else {
                         poll_immediate_wake();
                         clear_idl_track = false;
@@ -1130,11 +1186,13 @@ main(int argc, char *argv[])
                               "force recompute next time.");
                     inc_proc_northd_force_recompute_immediate();
                 }
+                update_sb_commit_state(&state, &ovnsb_idl_loop);
                 run_memory_trimmer(ovnnb_idl_loop.idl, activity);
             } else {
                 /* Make sure we send any pending requests, e.g., lock. */
                 ovsdb_idl_loop_commit_and_wait(&ovnnb_idl_loop);
                 ovsdb_idl_loop_commit_and_wait(&ovnsb_idl_loop);
+                update_sb_commit_state(&state, &ovnsb_idl_loop);
 
                 /* Force a full recompute next time we become active. */
                 inc_proc_northd_force_recompute();
@@ -1159,6 +1217,7 @@ main(int argc, char *argv[])
             ovsdb_idl_run(ovnsb_idl_loop.idl);
             ovsdb_idl_wait(ovnnb_idl_loop.idl);
             ovsdb_idl_wait(ovnsb_idl_loop.idl);
+            state.sb_commit_start_ms = 0;
 
             /* Force a full recompute next time we become active. */
             inc_proc_northd_force_recompute_immediate();
@@ -1274,6 +1333,10 @@ ovn_northd_status(struct unixctl_conn *conn, int argc OVS_UNUSED,
      */
     struct ds s = DS_EMPTY_INITIALIZER;
     ds_put_format(&s, "Status: %s\n", status);
+    if (state->sb_commit_start_ms) {
+        ds_put_format(&s, "SB commit: in progress for %lld ms\n",
+                      time_msec() - state->sb_commit_start_ms);
+    }
     unixctl_command_reply(conn, ds_cstr(&s));
     ds_destroy(&s);
 }
@@ -21,6 +21,7 @@
 #include "smap.h"
 #include "packets.h"
 #include "bitmap.h"
+#include "timeval.h"
 
 #include "ipam.h"
 
@@ -56,6 +57,79 @@ test_ipam_get_unused_ip(struct ovs_cmdl_context *ctx)
     ds_destroy(&err);
 }
 
+static void
+test_ipam_get_unused_mac(struct ovs_cmdl_context *ctx)
+{
+    set_mac_prefix(ctx->argv[1]);
+
+    ovs_be32 ip;
+    if (!ip_parse(ctx->argv[2], &ip)) {
+        ovs_fatal(0, "%s: bad IP address", ctx->argv[2]);
+    }
+
+    int num_macs;
+    str_to_int(ctx->argv[3], 0, &num_macs);
+
+    /* Any further arguments are MAC addresses already in use. */
+    for (int i = 4; i < ctx->argc; i++) {
+        struct eth_addr ea;
+        if (!eth_addr_from_string(ctx->argv[i], &ea)) {
+            ovs_fatal(0, "%s: bad MAC address", ctx->argv[i]);
+        }
+        ipam_insert_mac(&ea, true);
+    }
+
+    for (int i = 0; i < num_macs; i++) {
+        struct eth_addr ea;
+        eth_addr_from_uint64(ipam_get_unused_mac(ip), &ea);
+        printf(ETH_ADDR_FMT "\n", ETH_ADDR_ARGS(ea));
+        ipam_insert_mac(&ea, true);
+    }
+
+    cleanup_macam();
+}
+
+/* Fills the whole 'subnet' with dynamic IPv4 addresses and then allocates
+ * 'num_macs' dynamic MAC addresses, reporting how long each step took. */
+static void
+test_ipam_benchmark(struct ovs_cmdl_context *ctx)
+{
+    struct ipam_info info;
+
+    struct smap config = SMAP_INITIALIZER(&config);
+    smap_add(&config, "subnet", ctx->argv[1]);
+    init_ipam_info(&info, &config, "Benchmark");
+
+    int num_macs;
+    str_to_int(ctx->argv[2], 0, &num_macs);
+
+    long long int start = time_msec();
+    size_t n_ips = 0;
+    for (;;) {
+        uint32_t next_ip = ipam_get_unused_ip(&info);
+        if (!next_ip) {
+            break;
+        }
+        ovs_assert(ipam_insert_ip(&info, next_ip, true));
+        n_ips++;
+    }
+    printf("%"PRIuSIZE" IPv4 addresses: %lld ms\n",
+           n_ips, time_msec() - start);
+
+    set_mac_prefix("0a:00:00");
+    start = time_msec();
+    for (int i = 0; i < num_macs; i++) {
+        struct eth_addr ea;
+        eth_addr_from_uint64(ipam_get_unused_mac(htonl(0)), &ea);
+        ipam_insert_mac(&ea, true);
+    }
+    printf("%d MAC addresses: %lld ms\n", num_macs, time_msec() - start);
+
+    cleanup_macam();
+    smap_destroy(&config);
+    destroy_ipam_info(&info);
+}
+
 static void
 test_ipam_init_ipv4(struct ovs_cmdl_context *ctx)
 {
@@ -129,6 +203,9 @@ test_ipam_main(int argc, char *argv[])
     set_program_name(argv[0]);
     static const struct ovs_cmdl_command commands[] = {
         {"ipam_get_unused_ip", NULL, 2, 3, test_ipam_get_unused_ip, OVS_RO},
+        {"ipam_get_unused_mac", NULL, 3, INT_MAX, test_ipam_get_unused_mac,
+            OVS_RO},
+        {"ipam_benchmark", NULL, 2, 2, test_ipam_benchmark, OVS_RO},
         {"ipam_init_ipv6_prefix", NULL, 0, 1, test_ipam_init_ipv6_prefix,
             OVS_RO},
         {"ipam_init_ipv4", NULL, 1, 2, test_ipam_init_ipv4,
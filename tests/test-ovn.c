@@ -19,6 +19,7 @@
 #include <getopt.h>
 #include <sys/wait.h>
 
+#include "bitmap.h"
 #include "command-line.h"
 #include "dp-packet.h"
 #include "fatal-signal.h"
@@ -458,7 +459,13 @@ test_evaluate_expr(struct ovs_cmdl_context *ctx)
             expr = expr_annotate(expr, &symtab, &error);
         }
         if (!error) {
-            printf("%d\n", expr_evaluate(expr, &uflow, lookup_atoi_cb, NULL));
+            struct expr_program *prog = expr_compile(expr, lookup_atoi_cb,
+                                                     NULL);
+            bool result = expr_program_evaluate(prog, &uflow);
+            ovs_assert(result == expr_evaluate(expr, &uflow,
+                                               lookup_atoi_cb, NULL));
+            printf("%d\n", result);
+            expr_program_destroy(prog);
         } else {
             puts(error);
             free(error);
@@ -902,12 +909,30 @@ test_tree_shape_exhaustively(struct expr *expr, struct shash *symtab,
         init_terminal(terminals[i], 0, nvars, n_nvars, svars, n_svars);
     }
 
+    /* Every expression is evaluated against the same set of microflows, one
+     * for each substitution of values for the variables, so build them once
+     * and evaluate each expression against all of them in one batch. */
+    const int n_substs = 1 << (n_bits * n_nvars + n_svars);
+    struct flow *flows = xcalloc(n_substs, sizeof *flows);
+    for (int subst = 0; subst < n_substs; subst++) {
+        struct flow *f = &flows[subst];
+        for (int i = 0; i < n_nvars; i++) {
+            f->regs[i] = (subst >> (i * n_bits)) & var_mask;
+        }
+        for (int i = 0; i < n_svars; i++) {
+            f->regs[n_nvars + i] = (subst >> (n_nvars * n_bits + i)) & 1;
+        }
+    }
+    unsigned long *expected_bits = bitmap_allocate(n_substs);
+    unsigned long *actual_bits = bitmap_allocate(n_substs);
+
     struct ds s = DS_EMPTY_INITIALIZER;
-    struct flow f;
-    memset(&f, 0, sizeof f);
     for (;;) {
         for (int i = n_terminals - 1; ; i--) {
             if (!i) {
+                bitmap_free(actual_bits);
+                bitmap_free(expected_bits);
+                free(flows);
                 ds_destroy(&s);
                 return n_tested;
             }
@@ -965,18 +990,20 @@ test_tree_shape_exhaustively(struct expr *expr, struct shash *symtab,
                                   vector_len(&m->conjunctions));
             }
         }
-        for (int subst = 0; subst < 1 << (n_bits * n_nvars + n_svars);
-             subst++) {
-            for (int i = 0; i < n_nvars; i++) {
-                f.regs[i] = (subst >> (i * n_bits)) & var_mask;
-            }
-            for (int i = 0; i < n_svars; i++) {
-                f.regs[n_nvars + i] = ((subst >> (n_nvars * n_bits + i))
-                                       & 1);
-            }
 
-            bool expected = expr_evaluate(expr, &f, lookup_atoi_cb, NULL);
-            bool actual = expr_evaluate(modified, &f, lookup_atoi_cb, NULL);
+        struct expr_program *prog;
+
+        prog = expr_compile(expr, lookup_atoi_cb, NULL);
+        expr_program_evaluate_batch(prog, flows, n_substs, expected_bits);
+        expr_program_destroy(prog);
+
+        prog = expr_compile(modified, lookup_atoi_cb, NULL);
+        expr_program_evaluate_batch(prog, flows, n_substs, actual_bits);
+        expr_program_destroy(prog);
+
+        for (int subst = 0; subst < n_substs; subst++) {
+            bool expected = bitmap_is_set(expected_bits, subst);
+            bool actual = bitmap_is_set(actual_bits, subst);
             if (actual != expected) {
                 struct ds expr_s, modified_s;
 
@@ -1007,7 +1034,8 @@ test_tree_shape_exhaustively(struct expr *expr, struct shash *symtab,
 
             if (operation >= OP_FLOW) {
                 bool found = classifier_lookup(&cls, OVS_VERSION_MIN,
-                                               &f, NULL, NULL) != NULL;
+                                               &flows[subst], NULL,
+                                               NULL) != NULL;
                 if (expected != found) {
                     struct ds expr_s, modified_s;
 
@@ -36,6 +36,7 @@
 #include "timer.h"
 #include "unixctl.h"
 #include "util.h"
+#include "uuid.h"
 
 VLOG_DEFINE_THIS_MODULE(ovn_dbctl);
 
@@ -94,13 +95,17 @@ static bool will_detach(const struct ovs_cmdl_parsed_option *, size_t n);
 static void apply_options_direct(const struct ovn_dbctl_options *dbctl_options,
                                  const struct ovs_cmdl_parsed_option *,
                                  size_t n, struct shash *local_options);
+static void set_monitor_conditions(
+    const struct ovn_dbctl_options *dbctl_options,
+    const struct ctl_command *commands, size_t n_commands,
+    struct ovsdb_idl *idl);
 static char * OVS_WARN_UNUSED_RESULT run_prerequisites(
     const struct ovn_dbctl_options *dbctl_options,
     struct ctl_command[], size_t n_commands, struct ovsdb_idl *);
 static char * OVS_WARN_UNUSED_RESULT do_dbctl(
     const struct ovn_dbctl_options *dbctl_options,
     const char *args, struct ctl_command *, size_t n,
-    struct ovsdb_idl *, const struct timer *, bool *retry);
+    struct ovsdb_idl *, const struct timer *, bool *retry, bool *rerun);
 static char * OVS_WARN_UNUSED_RESULT main_loop(
     const struct ovn_dbctl_options *, const char *args,
     struct ctl_command *commands, size_t n_commands,
@@ -235,6 +240,7 @@ ovn_dbctl_main(int argc, char *argv[],
         if (error) {
             goto cleanup;
         }
+        set_monitor_conditions(dbctl_options, commands, n_commands, idl);
 
         error = main_loop(dbctl_options, args, commands, n_commands, idl, NULL);
 
@@ -295,14 +301,18 @@ main_loop(const struct ovn_dbctl_options *dbctl_options,
             idl_ready = false;
             seqno = ovsdb_idl_get_seqno(idl);
 
-            bool retry;
+            bool retry, rerun;
             char *error = do_dbctl(dbctl_options,
                                    args, commands, n_commands, idl,
-                                   wait_timeout, &retry);
+                                   wait_timeout, &retry, &rerun);
             if (error) {
                 return error;
             }
-            if (!retry) {
+            if (rerun) {
+                /* The commands committed part of their work and continue in
+                 * a new transaction right away. */
+                idl_ready = true;
+            } else if (!retry) {
                 return NULL;
             }
         }
@@ -685,6 +695,84 @@ run_prerequisites(const struct ovn_dbctl_options *dbctl_options,
     return NULL;
 }
 
+static const struct ovn_dbctl_cond_command *
+find_cond_command(const struct ovn_dbctl_options *dbctl_options,
+                  const char *name)
+{
+    for (const struct ovn_dbctl_cond_command *cc
+             = dbctl_options->cond_commands; cc->name; cc++) {
+        if (!strcmp(cc->name, name)) {
+            return cc;
+        }
+    }
+    return NULL;
+}
+
+/* Restricts the rows that 'idl' monitors to the ones that 'commands' need, if
+ * all of them declare those rows in 'dbctl_options->cond_commands'.
+ * Otherwise, leaves 'idl' monitoring all the rows of the registered tables. */
+static void
+set_monitor_conditions(const struct ovn_dbctl_options *dbctl_options,
+                       const struct ctl_command *commands, size_t n_commands,
+                       struct ovsdb_idl *idl)
+{
+    size_t n_tables = dbctl_options->n_cond_tables;
+    if (!dbctl_options->cond_commands || !n_commands) {
+        return;
+    }
+    ovs_assert(n_tables <= OVN_DBCTL_MAX_COND_TABLES);
+
+    struct ovsdb_idl_condition conds[OVN_DBCTL_MAX_COND_TABLES];
+    bool constrained[OVN_DBCTL_MAX_COND_TABLES] = { false };
+    bool all_rows[OVN_DBCTL_MAX_COND_TABLES] = { false };
+    bool use_conds = true;
+
+    for (size_t t = 0; t < n_tables; t++) {
+        ovsdb_idl_condition_init(&conds[t]);
+    }
+
+    for (size_t i = 0; i < n_commands && use_conds; i++) {
+        const struct ctl_command *c = &commands[i];
+        const struct ovn_dbctl_cond_command *cc
+            = find_cond_command(dbctl_options, c->syntax->name);
+        if (!cc || (cc->full_option
+                    && shash_find(&c->options, cc->full_option))) {
+            use_conds = false;
+            break;
+        }
+
+        for (size_t t = 0; t < n_tables; t++) {
+            int arg = cc->args[t];
+            if (arg == OVN_DBCTL_COND_ANY) {
+                continue;
+            } else if (arg == OVN_DBCTL_COND_ALL) {
+                all_rows[t] = true;
+            } else if (arg > 0 && arg < c->argc) {
+                struct uuid uuid;
+
+                /* Rows referred to by UUID would need a lookup in every
+                 * table that the UUID might belong to. */
+                if (uuid_from_string(&uuid, c->argv[arg])) {
+                    use_conds = false;
+                    break;
+                }
+                dbctl_options->cond_tables[t].add_clause(&conds[t],
+                                                         OVSDB_F_EQ,
+                                                         c->argv[arg]);
+            }
+            constrained[t] = true;
+        }
+    }
+
+    for (size_t t = 0; t < n_tables; t++) {
+        if (use_conds && constrained[t] && !all_rows[t]) {
+            ovsdb_idl_set_condition(idl, dbctl_options->cond_tables[t].table,
+                                    &conds[t]);
+        }
+        ovsdb_idl_condition_destroy(&conds[t]);
+    }
+}
+
 static void
 oneline_format(struct ds *lines, struct ds *s)
 {
@@ -721,7 +809,8 @@ oneline_print(struct ds *lines)
 static char *
 do_dbctl(const struct ovn_dbctl_options *dbctl_options,
          const char *args, struct ctl_command *commands, size_t n_commands,
-         struct ovsdb_idl *idl, const struct timer *wait_timeout, bool *retry)
+         struct ovsdb_idl *idl, const struct timer *wait_timeout, bool *retry,
+         bool *rerun)
 {
     struct ovsdb_idl_txn *txn;
     enum ovsdb_idl_txn_status status;
@@ -730,6 +819,7 @@ do_dbctl(const struct ovn_dbctl_options *dbctl_options,
     char *error = NULL;
 
     ovs_assert(retry);
+    *rerun = false;
 
     txn = the_idl_txn = ovsdb_idl_txn_create(idl);
     if (dry_run) {
@@ -764,6 +854,14 @@ do_dbctl(const struct ovn_dbctl_options *dbctl_options,
     }
     ctl_context_done(ctx, NULL);
 
+    bool more_txns = (!dry_run && dbctl_options->needs_more_txns
+                      && dbctl_options->needs_more_txns());
+    if (more_txns && n_commands > 1) {
+        error = xstrdup("commands that need more than one transaction "
+                        "cannot be combined with other commands");
+        goto out_error;
+    }
+
     SHASH_FOR_EACH (node, &symtab->sh) {
         struct ovsdb_symbol *symbol = node->data;
         if (!symbol->created) {
@@ -834,6 +932,12 @@ do_dbctl(const struct ovn_dbctl_options *dbctl_options,
         OVS_NOT_REACHED();
     }
 
+    if (more_txns) {
+        /* Leave the output and the wait for the last transaction. */
+        *rerun = true;
+        goto done;
+    }
+
     for (size_t i = 0; i < n_commands; i++) {
         struct ctl_command *c = &commands[i];
         struct ds *ds = &c->output;
@@ -856,6 +960,7 @@ do_dbctl(const struct ovn_dbctl_options *dbctl_options,
         }
     }
 
+done:
     dbctl_options->ctx_destroy(ctx);
     ovsdb_symbol_table_destroy(symtab);
     ovsdb_idl_txn_destroy(txn);
@@ -30,6 +30,39 @@ enum nbctl_wait_type {
     NBCTL_WAIT_HV               /* Wait for hypervisors to catch up. */
 };
 
+/* Conditional monitoring.
+ *
+ * In direct mode, a one-shot invocation only needs the rows that its commands
+ * refer to.  A command listed in 'cond_commands' declares, for each table in
+ * 'cond_tables', which rows of it the command needs.  If every command of an
+ * invocation is listed, the IDL monitors only those rows, otherwise it falls
+ * back to monitoring all the rows of the tables registered by the commands'
+ * prerequisites. */
+#define OVN_DBCTL_MAX_COND_TABLES 16
+
+/* Values of 'args' in struct ovn_dbctl_cond_command, besides a positive
+ * index into the command's argv, which stands for the rows whose key column
+ * is equal to that argument (or no rows if the optional argument is
+ * missing). */
+#define OVN_DBCTL_COND_NONE 0    /* No rows, e.g. the command only inserts. */
+#define OVN_DBCTL_COND_ANY (-1)  /* The command does not use the table. */
+#define OVN_DBCTL_COND_ALL (-2)  /* The command needs all the rows. */
+
+struct ovn_dbctl_cond_table {
+    const struct ovsdb_idl_table_class *table;
+
+    /* Adds a clause that matches the rows whose key column (usually "name")
+     * is equal to 'key'. */
+    void (*add_clause)(struct ovsdb_idl_condition *, enum ovsdb_function,
+                       const char *key);
+};
+
+struct ovn_dbctl_cond_command {
+    const char *name;           /* Command name, e.g. "lsp-add". */
+    const char *full_option;    /* Option, if any, that needs all rows. */
+    int args[OVN_DBCTL_MAX_COND_TABLES]; /* Indexed like 'cond_tables'. */
+};
+
 struct ovn_dbctl_options {
     const char *db_version;     /* Database schema version. */
     const char *default_db;     /* Default database remote. */
@@ -44,6 +77,11 @@ struct ovn_dbctl_options {
     struct cmd_show_table *cmd_show_table;
     const struct ctl_command_syntax *commands;
 
+    /* Optional, see "Conditional monitoring" above. */
+    const struct ovn_dbctl_cond_table *cond_tables;
+    size_t n_cond_tables;
+    const struct ovn_dbctl_cond_command *cond_commands; /* NULL terminated. */
+
     void (*usage)(void);
 
     void (*add_base_prerequisites)(struct ovsdb_idl *, enum nbctl_wait_type);
@@ -54,6 +92,13 @@ struct ovn_dbctl_options {
                           const struct timer *wait_timeout,
                           long long int start_time, bool print_wait_time);
 
+    /* Optional.  Called after the commands ran, before their transaction is
+     * committed.  Returns true if the commands have more work to do in
+     * further transactions (e.g. "import" commits its input in batches), in
+     * which case the commands run again once this transaction committed.
+     * Such commands must be the only one on the command line. */
+    bool (*needs_more_txns)(void);
+
     int (*get_inactivity_probe)(struct ovsdb_idl *);
     struct ctl_context *(*ctx_create)(void);
     void (*ctx_destroy)(struct ctl_context *);
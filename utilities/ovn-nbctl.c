@@ -58,6 +58,12 @@ VLOG_DEFINE_THIS_MODULE(nbctl);
  * change the database at all? */
 static bool force_wait = false;
 
+/* The state of the "import" command, across the transactions of a single
+ * invocation.  See "Bulk import" below. */
+struct nbctl_import;
+static struct nbctl_import *import_state;
+static void nbctl_import_destroy(struct nbctl_import *);
+
 static char *
 string_ptr(char *ptr)
 {
@@ -71,6 +77,8 @@ nbctl_add_base_prerequisites(struct ovsdb_idl *idl,
                              enum nbctl_wait_type wait_type)
 {
     force_wait = false;
+    nbctl_import_destroy(import_state);
+    import_state = NULL;
 
     ovsdb_idl_add_table(idl, &nbrec_table_nb_global);
     if (wait_type != NBCTL_WAIT_NONE) {
@@ -275,6 +283,9 @@ General commands:\n\
   show                      print overview of database contents\n\
   show SWITCH               print overview of database contents for SWITCH\n\
   show ROUTER               print overview of database contents for ROUTER\n\
+  [--batch-size=N] [--format={csv | json}] [--progress]\n\
+  import FILE               create the switches, ports, routers, ACLs and\n\
+                            load balancers described in FILE\n\
 \n\
 Logical switch commands:\n\
   ls-add [SWITCH]           create a logical switch named SWITCH\n\
@@ -2845,6 +2856,20 @@ parse_priority(const char *arg, int64_t *priority_p)
     return NULL;
 }
 
+static char * OVS_WARN_UNUSED_RESULT
+parse_acl_action(const char *action)
+{
+    /* Validate action. */
+    if (strcmp(action, "allow") && strcmp(action, "allow-related")
+        && strcmp(action, "allow-stateless") && strcmp(action, "drop")
+        && strcmp(action, "reject") && strcmp(action, "pass")) {
+        return xasprintf("%s: action must be one of \"allow\", "
+                         "\"allow-related\", \"allow-stateless\", "
+                         "\"drop\", and \"reject\"", action);
+    }
+    return NULL;
+}
+
 static char * OVS_WARN_UNUSED_RESULT
 parse_acl_label(const char *arg, int64_t *label_p)
 {
@@ -2926,13 +2951,9 @@ nbctl_acl_add(struct ctl_context *ctx)
         return;
     }
 
-    /* Validate action. */
-    if (strcmp(action, "allow") && strcmp(action, "allow-related")
-        && strcmp(action, "allow-stateless") && strcmp(action, "drop")
-        && strcmp(action, "reject") && strcmp(action, "pass")) {
-        ctl_error(ctx, "%s: action must be one of \"allow\", "
-                  "\"allow-related\", \"allow-stateless\", \"drop\", "
-                  "and \"reject\"", action);
+    error = parse_acl_action(action);
+    if (error) {
+        ctx->error = error;
         return;
     }
 
@@ -8690,6 +8711,1080 @@ nbctl_lsp_add_misc_port(struct ctl_context *ctx)
     shash_add(&nbctx->lsp_to_ls_map, lsp_name, ls);
 }
 
+/* Bulk import.
+ *
+ * "import" creates the switches, ports, routers, ACLs and load balancers
+ * described by a CSV or JSON file.  Unlike the individual commands, which
+ * scan whole tables to look rows up by name, it builds name indexes once per
+ * invocation and keeps them up to date with the rows it inserts.  It commits
+ * its input in batches of --batch-size records: ovn-dbctl runs it again, in a
+ * new transaction, for as long as nbctl_import_needs_more_txns() returns
+ * true, so its state lives in 'import_state' rather than in the context. */
+
+#define IMPORT_DEFAULT_BATCH_SIZE 1000
+
+/* A row that the import knows by name. */
+struct import_row {
+    const struct ovsdb_idl_table_class *table;
+    struct uuid uuid;           /* Temporary UUID until committed. */
+    char *owner;                /* For ports, the switch or router name. */
+    bool ambiguous;             /* More than one row has this name. */
+
+    /* In 'pending' while inserted by an uncommitted transaction. */
+    struct shash *index;
+    struct shash_node *node;
+    struct ovs_list pending_node;
+};
+
+struct nbctl_import;
+struct import_type {
+    const char *name;
+    size_t min_args;
+    size_t max_args;
+    char *(*run)(struct ctl_context *, struct nbctl_import *,
+                 char *args[], size_t n_args);
+};
+
+struct import_record {
+    const struct import_type *type;
+    struct svec fields;         /* Record type, then its arguments. */
+    int line;                   /* Line number in a CSV file, 0 for JSON. */
+};
+
+struct nbctl_import {
+    char *file_name;
+    struct import_record *records;
+    size_t n_records;
+    size_t allocated_records;
+    size_t next;                /* First record not committed yet. */
+    size_t batch_end;           /* End of the current transaction's batch. */
+
+    /* Name indexes, all of "struct import_row"s. */
+    struct shash switches;
+    struct shash switch_ports;
+    struct shash routers;
+    struct shash router_ports;
+    struct shash lbs;
+    struct sset acls;           /* Keys from import_acl_key(). */
+
+    /* Changes to the indexes made by the current transaction. */
+    struct ovs_list pending;    /* Contains "struct import_row"s. */
+    struct svec pending_acls;
+
+    /* A row inserted by the last committed transaction, to tell when the IDL
+     * has caught up with it. */
+    const struct ovsdb_idl_table_class *synced_table;
+    struct uuid synced_uuid;
+};
+
+static char *
+import_acl_key(const char *ls_name, const char *direction, int64_t priority,
+               const char *match)
+{
+    return xasprintf("%s\n%s\n%"PRId64"\n%s",
+                     ls_name, direction, priority, match);
+}
+
+static struct import_row *
+import_index_add(struct shash *index, const struct ovsdb_idl_table_class *tc,
+                 const char *name, const struct uuid *uuid, const char *owner)
+{
+    struct import_row *row = shash_find_data(index, name);
+    if (row) {
+        row->ambiguous = true;
+        return row;
+    }
+
+    row = xzalloc(sizeof *row);
+    row->table = tc;
+    row->uuid = *uuid;
+    row->owner = nullable_xstrdup(owner);
+    row->index = index;
+    row->node = shash_add(index, name, row);
+    ovs_list_init(&row->pending_node);
+    return row;
+}
+
+static void
+import_index_destroy(struct shash *index)
+{
+    struct shash_node *node;
+    SHASH_FOR_EACH (node, index) {
+        struct import_row *row = node->data;
+        free(row->owner);
+        free(row);
+    }
+    shash_destroy(index);
+}
+
+/* Records that the current transaction inserted the row 'uuid' named 'name'
+ * in 'index'. */
+static void
+import_insert(struct nbctl_import *imp, struct shash *index,
+              const struct ovsdb_idl_table_class *tc, const char *name,
+              const struct uuid *uuid, const char *owner)
+{
+    struct import_row *row = import_index_add(index, tc, name, uuid, owner);
+    ovs_list_push_back(&imp->pending, &row->pending_node);
+}
+
+/* Looks up 'name' in 'index', where 'what' describes the kind of row for
+ * error messages. */
+static char * OVS_WARN_UNUSED_RESULT
+import_find(const struct shash *index, const char *name, const char *what,
+            const struct uuid **uuidp)
+{
+    const struct import_row *row = shash_find_data(index, name);
+
+    *uuidp = NULL;
+    if (!row) {
+        return xasprintf("%s: %s name not found", name, what);
+    }
+    if (row->ambiguous) {
+        return xasprintf("%s: more than one %s has this name", name, what);
+    }
+    *uuidp = &row->uuid;
+    return NULL;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_get_ls(struct ctl_context *ctx, struct nbctl_import *imp,
+              const char *name, const struct nbrec_logical_switch **ls_p)
+{
+    const struct uuid *uuid;
+    char *error = import_find(&imp->switches, name, "switch", &uuid);
+    *ls_p = uuid ? nbrec_logical_switch_get_for_uuid(ctx->idl, uuid) : NULL;
+    if (!error && !*ls_p) {
+        error = xasprintf("%s: switch was deleted during the import", name);
+    }
+    return error;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_get_lr(struct ctl_context *ctx, struct nbctl_import *imp,
+              const char *name, const struct nbrec_logical_router **lr_p)
+{
+    const struct uuid *uuid;
+    char *error = import_find(&imp->routers, name, "router", &uuid);
+    *lr_p = uuid ? nbrec_logical_router_get_for_uuid(ctx->idl, uuid) : NULL;
+    if (!error && !*lr_p) {
+        error = xasprintf("%s: router was deleted during the import", name);
+    }
+    return error;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_get_lb(struct ctl_context *ctx, struct nbctl_import *imp,
+              const char *name, const struct nbrec_load_balancer **lb_p)
+{
+    const struct uuid *uuid;
+    char *error = import_find(&imp->lbs, name, "load balancer", &uuid);
+    *lb_p = uuid ? nbrec_load_balancer_get_for_uuid(ctx->idl, uuid) : NULL;
+    if (!error && !*lb_p) {
+        error = xasprintf("%s: load balancer was deleted during the import",
+                          name);
+    }
+    return error;
+}
+
+/* Records are idempotent, so that an interrupted import can simply be run
+ * again: rows that already exist with the same name are left as they are. */
+
+static char * OVS_WARN_UNUSED_RESULT
+import_ls(struct ctl_context *ctx, struct nbctl_import *imp,
+          char *args[], size_t n_args OVS_UNUSED)
+{
+    const char *ls_name = args[0];
+
+    if (shash_find(&imp->switches, ls_name)) {
+        return NULL;
+    }
+
+    struct nbrec_logical_switch *ls = nbrec_logical_switch_insert(ctx->txn);
+    nbrec_logical_switch_set_name(ls, ls_name);
+    import_insert(imp, &imp->switches, &nbrec_table_logical_switch, ls_name,
+                  &ls->header_.uuid, NULL);
+    return NULL;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_lsp(struct ctl_context *ctx, struct nbctl_import *imp,
+           char *args[], size_t n_args)
+{
+    const char *ls_name = args[0];
+    const char *lsp_name = args[1];
+
+    const struct nbrec_logical_switch *ls;
+    char *error = import_get_ls(ctx, imp, ls_name, &ls);
+    if (error) {
+        return error;
+    }
+
+    const struct import_row *row = shash_find_data(&imp->switch_ports,
+                                                   lsp_name);
+    if (row) {
+        if (strcmp(row->owner, ls_name)) {
+            return xasprintf("%s: port already exists but in switch %s",
+                             lsp_name, row->owner);
+        }
+        return NULL;
+    }
+
+    struct nbrec_logical_switch_port *lsp
+        = nbrec_logical_switch_port_insert(ctx->txn);
+    nbrec_logical_switch_port_set_name(lsp, lsp_name);
+    nbrec_logical_switch_port_set_addresses(lsp, (const char **) &args[2],
+                                            n_args - 2);
+    nbrec_logical_switch_update_ports_addvalue(ls, lsp);
+    import_insert(imp, &imp->switch_ports, &nbrec_table_logical_switch_port,
+                  lsp_name, &lsp->header_.uuid, ls_name);
+    return NULL;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_lr(struct ctl_context *ctx, struct nbctl_import *imp,
+          char *args[], size_t n_args OVS_UNUSED)
+{
+    const char *lr_name = args[0];
+
+    if (shash_find(&imp->routers, lr_name)) {
+        return NULL;
+    }
+
+    struct nbrec_logical_router *lr = nbrec_logical_router_insert(ctx->txn);
+    nbrec_logical_router_set_name(lr, lr_name);
+    import_insert(imp, &imp->routers, &nbrec_table_logical_router, lr_name,
+                  &lr->header_.uuid, NULL);
+    return NULL;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_lrp(struct ctl_context *ctx, struct nbctl_import *imp,
+           char *args[], size_t n_args)
+{
+    const char *lr_name = args[0];
+    const char *lrp_name = args[1];
+    const char *mac = args[2];
+    const char **networks = (const char **) &args[3];
+    size_t n_networks = n_args - 3;
+
+    const struct nbrec_logical_router *lr;
+    char *error = import_get_lr(ctx, imp, lr_name, &lr);
+    if (error) {
+        return error;
+    }
+
+    struct eth_addr ea;
+    if (!eth_addr_from_string(mac, &ea)) {
+        return xasprintf("%s: invalid mac address %s", lrp_name, mac);
+    }
+    struct sset *network_set = lrp_network_sset(networks, (int) n_networks);
+    if (!network_set) {
+        return xasprintf("%s: Invalid networks configured", lrp_name);
+    }
+    sset_destroy(network_set);
+    free(network_set);
+
+    const struct import_row *row = shash_find_data(&imp->router_ports,
+                                                   lrp_name);
+    if (row) {
+        if (strcmp(row->owner, lr_name)) {
+            return xasprintf("%s: port already exists but in router %s",
+                             lrp_name, row->owner);
+        }
+        return NULL;
+    }
+
+    struct nbrec_logical_router_port *lrp
+        = nbrec_logical_router_port_insert(ctx->txn);
+    nbrec_logical_router_port_set_name(lrp, lrp_name);
+    nbrec_logical_router_port_set_mac(lrp, mac);
+    nbrec_logical_router_port_set_networks(lrp, networks, n_networks);
+    nbrec_logical_router_update_ports_addvalue(lr, lrp);
+    import_insert(imp, &imp->router_ports, &nbrec_table_logical_router_port,
+                  lrp_name, &lrp->header_.uuid, lr_name);
+    return NULL;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_acl(struct ctl_context *ctx, struct nbctl_import *imp,
+           char *args[], size_t n_args OVS_UNUSED)
+{
+    const char *ls_name = args[0];
+    const char *match = args[3];
+    const char *action = args[4];
+
+    const struct nbrec_logical_switch *ls;
+    char *error = import_get_ls(ctx, imp, ls_name, &ls);
+    if (error) {
+        return error;
+    }
+
+    const char *direction;
+    int64_t priority = 0;
+    error = parse_direction(args[1], &direction);
+    if (!error) {
+        error = parse_priority(args[2], &priority);
+    }
+    if (!error) {
+        error = parse_acl_action(action);
+    }
+    if (error) {
+        return error;
+    }
+
+    char *key = import_acl_key(ls_name, direction, priority, match);
+    if (!sset_add(&imp->acls, key)) {
+        free(key);
+        return NULL;
+    }
+    svec_add_nocopy(&imp->pending_acls, key);
+
+    struct nbrec_acl *acl = nbrec_acl_insert(ctx->txn);
+    nbrec_acl_set_priority(acl, priority);
+    nbrec_acl_set_direction(acl, direction);
+    nbrec_acl_set_match(acl, match);
+    nbrec_acl_set_action(acl, action);
+    nbrec_logical_switch_update_acls_addvalue(ls, acl);
+    return NULL;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_lb(struct ctl_context *ctx, struct nbctl_import *imp,
+          char *args[], size_t n_args)
+{
+    const char *lb_name = args[0];
+    const char *lb_proto = n_args > 3 ? args[3] : NULL;
+
+    if (lb_proto && strcmp(lb_proto, "tcp") && strcmp(lb_proto, "udp")
+        && strcmp(lb_proto, "sctp")) {
+        return xasprintf("%s: protocol must be one of \"tcp\", \"udp\", "
+                         " or \"sctp\".", lb_proto);
+    }
+
+    struct ovn_lb_vip lb_vip_parsed;
+    char *error = ovn_lb_vip_init(&lb_vip_parsed, args[1], args[2], false,
+                                  AF_INET);
+    if (error) {
+        ovn_lb_vip_destroy(&lb_vip_parsed);
+        return error;
+    }
+    if (lb_proto && !lb_vip_parsed.port_str) {
+        ovn_lb_vip_destroy(&lb_vip_parsed);
+        return xstrdup("Protocol is unnecessary when no port of vip is "
+                       "given.");
+    }
+
+    struct ds vip = DS_EMPTY_INITIALIZER;
+    struct ds backends = DS_EMPTY_INITIALIZER;
+    ovn_lb_vip_format(&lb_vip_parsed, &vip, false);
+    ovn_lb_vip_backends_format(&lb_vip_parsed, &backends);
+    ovn_lb_vip_destroy(&lb_vip_parsed);
+
+    if (shash_find(&imp->lbs, lb_name)) {
+        /* More VIPs for a load balancer, as with "lb-add --may-exist". */
+        const struct nbrec_load_balancer *lb;
+        error = import_get_lb(ctx, imp, lb_name, &lb);
+        if (!error) {
+            nbrec_load_balancer_update_vips_setkey(lb, ds_cstr(&vip),
+                                                   ds_cstr(&backends));
+        }
+    } else {
+        struct nbrec_load_balancer *lb
+            = nbrec_load_balancer_insert(ctx->txn);
+        nbrec_load_balancer_set_name(lb, lb_name);
+        nbrec_load_balancer_set_protocol(lb, lb_proto ? lb_proto : "tcp");
+        const struct smap vips = SMAP_CONST1(&vips, ds_cstr(&vip),
+                                             ds_cstr(&backends));
+        nbrec_load_balancer_set_vips(lb, &vips);
+        import_insert(imp, &imp->lbs, &nbrec_table_load_balancer, lb_name,
+                      &lb->header_.uuid, NULL);
+    }
+
+    ds_destroy(&vip);
+    ds_destroy(&backends);
+    return error;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_ls_lb(struct ctl_context *ctx, struct nbctl_import *imp,
+             char *args[], size_t n_args OVS_UNUSED)
+{
+    const struct nbrec_logical_switch *ls;
+    const struct nbrec_load_balancer *lb;
+
+    char *error = import_get_ls(ctx, imp, args[0], &ls);
+    if (!error) {
+        error = import_get_lb(ctx, imp, args[1], &lb);
+    }
+    if (!error) {
+        nbrec_logical_switch_update_load_balancer_addvalue(ls, lb);
+    }
+    return error;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_lr_lb(struct ctl_context *ctx, struct nbctl_import *imp,
+             char *args[], size_t n_args OVS_UNUSED)
+{
+    const struct nbrec_logical_router *lr;
+    const struct nbrec_load_balancer *lb;
+
+    char *error = import_get_lr(ctx, imp, args[0], &lr);
+    if (!error) {
+        error = import_get_lb(ctx, imp, args[1], &lb);
+    }
+    if (!error) {
+        nbrec_logical_router_update_load_balancer_addvalue(lr, lb);
+    }
+    return error;
+}
+
+static const struct import_type import_types[] = {
+    { "ls", 1, 1, import_ls },
+    { "lsp", 2, SIZE_MAX, import_lsp },
+    { "lr", 1, 1, import_lr },
+    { "lrp", 4, SIZE_MAX, import_lrp },
+    { "acl", 5, 5, import_acl },
+    { "lb", 3, 4, import_lb },
+    { "ls-lb", 2, 2, import_ls_lb },
+    { "lr-lb", 2, 2, import_lr_lb },
+};
+
+/* Appends a record made of 'fields' to 'imp', taking ownership of the
+ * strings in 'fields' and leaving it empty. */
+static char * OVS_WARN_UNUSED_RESULT
+import_add_record(struct nbctl_import *imp, struct svec *fields, int line)
+{
+    const struct import_type *type = NULL;
+    for (size_t i = 0; i < ARRAY_SIZE(import_types); i++) {
+        if (!strcmp(import_types[i].name, fields->names[0])) {
+            type = &import_types[i];
+            break;
+        }
+    }
+    if (!type) {
+        return xasprintf("unknown record type \"%s\"", fields->names[0]);
+    }
+
+    size_t n_args = fields->n - 1;
+    if (n_args < type->min_args || n_args > type->max_args) {
+        return xasprintf("\"%s\" record has %"PRIuSIZE" arguments",
+                         type->name, n_args);
+    }
+
+    if (imp->n_records >= imp->allocated_records) {
+        imp->records = x2nrealloc(imp->records, &imp->allocated_records,
+                                  sizeof *imp->records);
+    }
+    struct import_record *record = &imp->records[imp->n_records++];
+    record->type = type;
+    record->fields = *fields;
+    record->line = line;
+    svec_init(fields);
+    return NULL;
+}
+
+/* Splits CSV 'line' into 'fields'.  A field enclosed in double quotes may
+ * contain commas, and "" within it stands for one double quote. */
+static char * OVS_WARN_UNUSED_RESULT
+import_parse_csv_line(const char *line, struct svec *fields)
+{
+    struct ds field = DS_EMPTY_INITIALIZER;
+    const char *p = line;
+
+    for (;;) {
+        ds_clear(&field);
+        p += strspn(p, " \t");
+        if (*p == '"') {
+            for (p++; ; p++) {
+                if (*p == '\0') {
+                    ds_destroy(&field);
+                    return xstrdup("unterminated quoted field");
+                } else if (*p == '"') {
+                    if (p[1] != '"') {
+                        p++;
+                        break;
+                    }
+                    p++;
+                }
+                ds_put_char(&field, *p);
+            }
+            p += strspn(p, " \t");
+            if (*p != ',' && *p != '\0') {
+                ds_destroy(&field);
+                return xstrdup("unexpected text after quoted field");
+            }
+        } else {
+            size_t len = strcspn(p, ",");
+            ds_put_buffer(&field, p, len);
+            p += len;
+            while (field.length
+                   && strchr(" \t", field.string[field.length - 1])) {
+                field.length--;
+            }
+        }
+        svec_add(fields, ds_cstr(&field));
+
+        if (*p != ',') {
+            break;
+        }
+        p++;
+    }
+
+    ds_destroy(&field);
+    return NULL;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_parse_csv(struct nbctl_import *imp, char *s)
+{
+    struct svec fields = SVEC_EMPTY_INITIALIZER;
+    char *error = NULL;
+    int line_number = 0;
+
+    while (*s && !error) {
+        char *line = s;
+        size_t len = strcspn(s, "\n");
+        s += len + (s[len] == '\n');
+        line[len] = '\0';
+        if (len && line[len - 1] == '\r') {
+            line[len - 1] = '\0';
+        }
+        line_number++;
+
+        line += strspn(line, " \t");
+        if (*line == '\0' || *line == '#') {
+            continue;
+        }
+
+        svec_clear(&fields);
+        error = import_parse_csv_line(line, &fields);
+        if (!error) {
+            error = import_add_record(imp, &fields, line_number);
+        }
+        if (error) {
+            char *msg = error;
+            error = xasprintf("%s:%d: %s", imp->file_name, line_number, msg);
+            free(msg);
+        }
+    }
+
+    svec_destroy(&fields);
+    return error;
+}
+
+/* Stores member 'key' of JSON object 'obj' in '*valuep', or NULL if 'obj'
+ * has no such member. */
+static char * OVS_WARN_UNUSED_RESULT
+import_json_get(const struct json *obj, const char *key,
+                enum json_type type, bool required,
+                const struct json **valuep)
+{
+    const struct json *value = shash_find_data(json_object(obj), key);
+
+    *valuep = NULL;
+    if (!value) {
+        return required ? xasprintf("missing \"%s\"", key) : NULL;
+    }
+    if (value->type != type) {
+        return xasprintf("\"%s\" must be of type %s",
+                         key, json_type_to_string(type));
+    }
+    *valuep = value;
+    return NULL;
+}
+
+/* Appends the string member 'key' of 'obj' to 'fields'. */
+static char * OVS_WARN_UNUSED_RESULT
+import_json_add_string(const struct json *obj, const char *key,
+                       bool required, struct svec *fields)
+{
+    const struct json *value;
+    char *error = import_json_get(obj, key, JSON_STRING, required, &value);
+    if (value) {
+        svec_add(fields, json_string(value));
+    }
+    return error;
+}
+
+/* Appends the strings in array member 'key' of 'obj' to 'fields'. */
+static char * OVS_WARN_UNUSED_RESULT
+import_json_add_strings(const struct json *obj, const char *key,
+                        struct svec *fields)
+{
+    const struct json *array;
+    char *error = import_json_get(obj, key, JSON_ARRAY, false, &array);
+    for (size_t i = 0; array && i < json_array_size(array); i++) {
+        const struct json *elem = json_array_at(array, i);
+        if (elem->type != JSON_STRING) {
+            return xasprintf("\"%s\" must contain strings", key);
+        }
+        svec_add(fields, json_string(elem));
+    }
+    return error;
+}
+
+/* Appends one record to 'imp' for each element of array member 'key' of
+ * 'obj', each made of 'type', 'owner' (if nonnull) and the members of the
+ * element listed in 'members' (the last of which may be an array). */
+static char * OVS_WARN_UNUSED_RESULT
+import_json_add_records(struct nbctl_import *imp, const struct json *obj,
+                        const char *key, const char *type, const char *owner,
+                        const char *const members[], size_t n_members,
+                        bool last_is_array)
+{
+    struct svec fields = SVEC_EMPTY_INITIALIZER;
+    const struct json *array;
+
+    char *error = import_json_get(obj, key, JSON_ARRAY, false, &array);
+    for (size_t i = 0; !error && array && i < json_array_size(array); i++) {
+        const struct json *elem = json_array_at(array, i);
+
+        svec_clear(&fields);
+        svec_add(&fields, type);
+        if (owner) {
+            svec_add(&fields, owner);
+        }
+        if (!n_members) {
+            /* The elements are just names. */
+            if (elem->type != JSON_STRING) {
+                error = xasprintf("\"%s\" must contain strings", key);
+                break;
+            }
+            svec_add(&fields, json_string(elem));
+        } else if (elem->type != JSON_OBJECT) {
+            error = xasprintf("\"%s\" must contain objects", key);
+            break;
+        }
+        for (size_t j = 0; !error && j < n_members; j++) {
+            if (last_is_array && j == n_members - 1) {
+                error = import_json_add_strings(elem, members[j], &fields);
+            } else if (!strcmp(members[j], "priority")) {
+                const struct json *value = shash_find_data(
+                    json_object(elem), "priority");
+                if (value && value->type == JSON_INTEGER) {
+                    svec_add_nocopy(&fields, xasprintf(
+                                        "%lld", json_integer(value)));
+                } else {
+                    error = import_json_add_string(elem, members[j], true,
+                                                   &fields);
+                }
+            } else {
+                error = import_json_add_string(elem, members[j], true,
+                                               &fields);
+            }
+        }
+        if (!error) {
+            error = import_add_record(imp, &fields, 0);
+        }
+    }
+
+    svec_destroy(&fields);
+    return error;
+}
+
+static char * OVS_WARN_UNUSED_RESULT
+import_parse_json_lbs(struct nbctl_import *imp, const struct json *json)
+{
+    const struct json *lbs;
+    char *error = import_json_get(json, "load_balancers", JSON_ARRAY, false,
+                                  &lbs);
+    for (size_t i = 0; !error && lbs && i < json_array_size(lbs); i++) {
+        const struct json *lb = json_array_at(lbs, i);
+        const struct json *name, *vips, *proto;
+
+        if (lb->type != JSON_OBJECT) {
+            return xstrdup("\"load_balancers\" must contain objects");
+        }
+        error = import_json_get(lb, "name", JSON_STRING, true, &name);
+        if (!error) {
+            error = import_json_get(lb, "vips", JSON_OBJECT, true, &vips);
+        }
+        if (!error) {
+            error = import_json_get(lb, "protocol", JSON_STRING, false,
+                                    &proto);
+        }
+        if (error) {
+            break;
+        }
+
+        struct shash_node *node;
+        SHASH_FOR_EACH (node, json_object(vips)) {
+            const struct json *backends = node->data;
+            if (backends->type != JSON_STRING) {
+                return xasprintf("%s: \"vips\" must map to strings",
+                                 json_string(name));
+            }
+
+            struct svec fields = SVEC_EMPTY_INITIALIZER;
+            svec_add(&fields, "lb");
+            svec_add(&fields, json_string(name));
+            svec_add(&fields, node->name);
+            svec_add(&fields, json_string(backends));
+            if (proto) {
+                svec_add(&fields, json_string(proto));
+            }
+            error = import_add_record(imp, &fields, 0);
+            svec_destroy(&fields);
+            if (error) {
+                break;
+            }
+        }
+    }
+    return error;
+}
+
+/* Parses 'json', which looks like:
+ *
+ * {"load_balancers": [{"name": LB, "vips": {VIP: BACKENDS...},
+ *                      "protocol": PROTOCOL}...],
+ *  "switches": [{"name": SWITCH,
+ *                "ports": [{"name": PORT, "addresses": [ADDRESS...]}...],
+ *                "acls": [{"direction": DIRECTION, "priority": PRIORITY,
+ *                          "match": MATCH, "action": ACTION}...],
+ *                "load_balancers": [LB...]}...],
+ *  "routers": [{"name": ROUTER,
+ *               "ports": [{"name": PORT, "mac": MAC,
+ *                          "networks": [NETWORK...]}...],
+ *               "load_balancers": [LB...]}...]}
+ *
+ * into the same records as the equivalent CSV file. */
+static char * OVS_WARN_UNUSED_RESULT
+import_parse_json(struct nbctl_import *imp, const struct json *json)
+{
+    static const char *const name[] = { "name" };
+    static const char *const lsp[] = { "name", "addresses" };
+    static const char *const acl[] = { "direction", "priority", "match",
+                                       "action" };
+    static const char *const lrp[] = { "name", "mac", "networks" };
+
+    if (json->type != JSON_OBJECT) {
+        return xstrdup("top-level JSON value must be an object");
+    }
+
+    char *error = import_parse_json_lbs(imp, json);
+    if (!error) {
+        error = import_json_add_records(imp, json, "switches", "ls", NULL,
+                                        name, 1, false);
+    }
+    if (!error) {
+        error = import_json_add_records(imp, json, "routers", "lr", NULL,
+                                        name, 1, false);
+    }
+
+    /* Ports, ACLs and load balancer associations, now that all the switches
+     * and routers have a record. */
+    for (int i = 0; !error && i < 2; i++) {
+        bool is_ls = i == 0;
+        const char *key = is_ls ? "switches" : "routers";
+        const struct json *array;
+
+        error = import_json_get(json, key, JSON_ARRAY, false, &array);
+        for (size_t j = 0; !error && array && j < json_array_size(array);
+             j++) {
+            const struct json *elem = json_array_at(array, j);
+            const char *owner = json_string(shash_find_data(
+                                                json_object(elem), "name"));
+            if (is_ls) {
+                error = import_json_add_records(imp, elem, "ports", "lsp",
+                                                owner, lsp, 2, true);
+                if (!error) {
+                    error = import_json_add_records(imp, elem, "acls", "acl",
+                                                    owner, acl, 4, false);
+                }
+            } else {
+                error = import_json_add_records(imp, elem, "ports", "lrp",
+                                                owner, lrp, 3, true);
+            }
+            if (!error) {
+                error = import_json_add_records(imp, elem, "load_balancers",
+                                                is_ls ? "ls-lb" : "lr-lb",
+                                                owner, NULL, 0, false);
+            }
+        }
+    }
+
+    if (error) {
+        char *msg = error;
+        error = xasprintf("%s: %s", imp->file_name, msg);
+        free(msg);
+    }
+    return error;
+}
+
+static void
+nbctl_import_destroy(struct nbctl_import *imp)
+{
+    if (!imp) {
+        return;
+    }
+
+    for (size_t i = 0; i < imp->n_records; i++) {
+        svec_destroy(&imp->records[i].fields);
+    }
+    free(imp->records);
+    free(imp->file_name);
+
+    import_index_destroy(&imp->switches);
+    import_index_destroy(&imp->switch_ports);
+    import_index_destroy(&imp->routers);
+    import_index_destroy(&imp->router_ports);
+    import_index_destroy(&imp->lbs);
+    sset_destroy(&imp->acls);
+    svec_destroy(&imp->pending_acls);
+    free(imp);
+}
+
+/* Reads and parses 'file_name' ("-" for stdin), in 'format' ("csv", "json",
+ * or NULL to guess from the contents). */
+static char * OVS_WARN_UNUSED_RESULT
+import_create(const char *file_name, const char *format,
+              struct nbctl_import **impp)
+{
+    *impp = NULL;
+    if (format && strcmp(format, "csv") && strcmp(format, "json")) {
+        return xasprintf("%s: format must be \"csv\" or \"json\"", format);
+    }
+
+    FILE *stream = !strcmp(file_name, "-") ? stdin : fopen(file_name, "r");
+    if (!stream) {
+        return xasprintf("%s: open failed (%s)",
+                         file_name, ovs_strerror(errno));
+    }
+
+    struct ds s = DS_EMPTY_INITIALIZER;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof buf, stream)) > 0) {
+        ds_put_buffer(&s, buf, n);
+    }
+    bool read_error = ferror(stream);
+    if (stream != stdin) {
+        fclose(stream);
+    }
+    if (read_error) {
+        ds_destroy(&s);
+        return xasprintf("%s: read failed", file_name);
+    }
+
+    struct nbctl_import *imp = xzalloc(sizeof *imp);
+    imp->file_name = xstrdup(file_name);
+    shash_init(&imp->switches);
+    shash_init(&imp->switch_ports);
+    shash_init(&imp->routers);
+    shash_init(&imp->router_ports);
+    shash_init(&imp->lbs);
+    sset_init(&imp->acls);
+    ovs_list_init(&imp->pending);
+    svec_init(&imp->pending_acls);
+
+    char *contents = ds_cstr(&s);
+    if (!format) {
+        format = contents[strspn(contents, " \t\r\n")] == '{' ? "json" : "csv";
+    }
+
+    char *error;
+    if (!strcmp(format, "json")) {
+        struct json *json = json_from_string(contents);
+        if (json->type == JSON_STRING) {
+            error = xasprintf("%s: %s", file_name, json_string(json));
+        } else {
+            error = import_parse_json(imp, json);
+        }
+        json_destroy(json);
+    } else {
+        error = import_parse_csv(imp, contents);
+    }
+    ds_destroy(&s);
+
+    if (error) {
+        nbctl_import_destroy(imp);
+        return error;
+    }
+    *impp = imp;
+    return NULL;
+}
+
+static void
+import_build_indexes(struct ctl_context *ctx, struct nbctl_import *imp)
+{
+    const struct nbrec_logical_switch *ls;
+    NBREC_LOGICAL_SWITCH_FOR_EACH (ls, ctx->idl) {
+        import_index_add(&imp->switches, &nbrec_table_logical_switch,
+                         ls->name, &ls->header_.uuid, NULL);
+        for (size_t i = 0; i < ls->n_ports; i++) {
+            const struct nbrec_logical_switch_port *lsp = ls->ports[i];
+            import_index_add(&imp->switch_ports,
+                             &nbrec_table_logical_switch_port,
+                             lsp->name, &lsp->header_.uuid, ls->name);
+        }
+        for (size_t i = 0; i < ls->n_acls; i++) {
+            const struct nbrec_acl *acl = ls->acls[i];
+            sset_add_and_free(&imp->acls,
+                              import_acl_key(ls->name, acl->direction,
+                                             acl->priority, acl->match));
+        }
+    }
+
+    const struct nbrec_logical_router *lr;
+    NBREC_LOGICAL_ROUTER_FOR_EACH (lr, ctx->idl) {
+        import_index_add(&imp->routers, &nbrec_table_logical_router,
+                         lr->name, &lr->header_.uuid, NULL);
+        for (size_t i = 0; i < lr->n_ports; i++) {
+            const struct nbrec_logical_router_port *lrp = lr->ports[i];
+            import_index_add(&imp->router_ports,
+                             &nbrec_table_logical_router_port,
+                             lrp->name, &lrp->header_.uuid, lr->name);
+        }
+    }
+
+    const struct nbrec_load_balancer *lb;
+    NBREC_LOAD_BALANCER_FOR_EACH (lb, ctx->idl) {
+        import_index_add(&imp->lbs, &nbrec_table_load_balancer,
+                         lb->name, &lb->header_.uuid, NULL);
+    }
+}
+
+/* Forgets the rows inserted by a transaction that did not commit. */
+static void
+import_rollback(struct nbctl_import *imp)
+{
+    struct import_row *row;
+    LIST_FOR_EACH_POP (row, pending_node, &imp->pending) {
+        shash_delete(row->index, row->node);
+        free(row->owner);
+        free(row);
+    }
+
+    const char *key;
+    size_t i;
+    SVEC_FOR_EACH (i, key, &imp->pending_acls) {
+        sset_find_and_delete(&imp->acls, key);
+    }
+    svec_clear(&imp->pending_acls);
+}
+
+/* Replaces the temporary UUIDs of the rows inserted by 'txn', which
+ * committed, by their permanent ones. */
+static void
+import_commit(struct nbctl_import *imp, struct ovsdb_idl_txn *txn)
+{
+    struct import_row *row;
+    LIST_FOR_EACH_POP (row, pending_node, &imp->pending) {
+        const struct uuid *uuid = ovsdb_idl_txn_get_insert_uuid(txn,
+                                                                 &row->uuid);
+        if (uuid) {
+            row->uuid = *uuid;
+            imp->synced_table = row->table;
+            imp->synced_uuid = *uuid;
+        }
+    }
+    svec_clear(&imp->pending_acls);
+    imp->next = imp->batch_end;
+}
+
+static bool
+nbctl_import_needs_more_txns(void)
+{
+    return import_state && import_state->batch_end < import_state->n_records;
+}
+
+static void
+nbctl_pre_import(struct ctl_context *ctx)
+{
+    nbctl_pre_context(ctx);
+
+    ovsdb_idl_add_column(ctx->idl, &nbrec_logical_switch_col_acls);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_logical_switch_col_load_balancer);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_logical_switch_port_col_addresses);
+
+    ovsdb_idl_add_column(ctx->idl, &nbrec_logical_router_col_load_balancer);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_logical_router_port_col_mac);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_logical_router_port_col_networks);
+
+    ovsdb_idl_add_column(ctx->idl, &nbrec_acl_col_direction);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_acl_col_priority);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_acl_col_match);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_acl_col_action);
+
+    ovsdb_idl_add_column(ctx->idl, &nbrec_load_balancer_col_name);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_load_balancer_col_protocol);
+    ovsdb_idl_add_column(ctx->idl, &nbrec_load_balancer_col_vips);
+}
+
+static void
+nbctl_import(struct ctl_context *ctx)
+{
+    const char *batch_size_s = shash_find_data(&ctx->options, "--batch-size");
+    const char *format = shash_find_data(&ctx->options, "--format");
+    unsigned int batch_size = IMPORT_DEFAULT_BATCH_SIZE;
+
+    if (batch_size_s && !str_to_uint(batch_size_s, 10, &batch_size)) {
+        ctl_error(ctx, "%s: invalid batch size", batch_size_s);
+        return;
+    }
+
+    if (!import_state) {
+        char *error = import_create(ctx->argv[1], format, &import_state);
+        if (error) {
+            ctx->error = error;
+            return;
+        }
+        import_build_indexes(ctx, import_state);
+    }
+
+    struct nbctl_import *imp = import_state;
+    if (imp->synced_table
+        && !ovsdb_idl_get_row_for_uuid(ctx->idl, imp->synced_table,
+                                       &imp->synced_uuid)) {
+        /* The IDL does not have the rows committed by the previous batch
+         * yet. */
+        ctx->try_again = true;
+        return;
+    }
+    import_rollback(imp);
+
+    size_t n = imp->n_records - imp->next;
+    size_t end = imp->next + (batch_size ? MIN(batch_size, n) : n);
+    for (size_t i = imp->next; i < end; i++) {
+        const struct import_record *record = &imp->records[i];
+        char *error = record->type->run(ctx, imp, &record->fields.names[1],
+                                        record->fields.n - 1);
+        if (error) {
+            if (record->line) {
+                ctl_error(ctx, "%s:%d: %s",
+                          imp->file_name, record->line, error);
+            } else {
+                ctl_error(ctx, "%s: %s record %"PRIuSIZE": %s",
+                          imp->file_name, record->type->name, i + 1, error);
+            }
+            free(error);
+            return;
+        }
+    }
+    imp->batch_end = end;
+}
+
+static void
+nbctl_import_postprocess(struct ctl_context *ctx)
+{
+    struct nbctl_import *imp = import_state;
+    if (!imp) {
+        return;
+    }
+
+    import_commit(imp, ctx->txn);
+    if (shash_find(&ctx->options, "--progress")) {
+        fprintf(stderr, "%s: %"PRIuSIZE" of %"PRIuSIZE" records imported\n",
+                imp->file_name, imp->next, imp->n_records);
+    }
+    if (imp->next >= imp->n_records) {
+        nbctl_import_destroy(imp);
+        import_state = NULL;
+    }
+}
+
 static const struct ctl_table_class tables[NBREC_N_TABLES] = {
     [NBREC_TABLE_DHCP_OPTIONS].row_ids
     = {{&nbrec_logical_switch_port_col_name, NULL,
@@ -8760,6 +9855,8 @@ static const struct ctl_command_syntax nbctl_commands[] = {
     { "init", 0, 0, "", NULL, nbctl_init, NULL, "", RW },
     { "sync", 0, 0, "", nbctl_pre_sync, nbctl_sync, NULL, "", RO },
     { "show", 0, 1, "[SWITCH]", nbctl_pre_show, nbctl_show, NULL, "", RO },
+    { "import", 1, 1, "FILE", nbctl_pre_import, nbctl_import,
+      nbctl_import_postprocess, "--batch-size=,--format=,--progress", RW },
 
     /* logical switch commands. */
     { "ls-add", 0, 1, "[SWITCH]", nbctl_pre_ls_add, nbctl_ls_add, NULL,
@@ -9080,6 +10177,56 @@ static const struct ctl_command_syntax nbctl_commands[] = {
     {NULL, 0, 0, NULL, NULL, NULL, NULL, "", RO},
 };
 
+/* Tables whose rows a one-shot invocation can look up by name, see
+ * "Conditional monitoring" in ovn-dbctl.h. */
+enum {
+    NBCTL_COND_LS,
+    NBCTL_COND_LSP,
+    NBCTL_COND_LR,
+    NBCTL_COND_LRP,
+    NBCTL_N_COND_TABLES
+};
+
+static const struct ovn_dbctl_cond_table nbctl_cond_tables[] = {
+    [NBCTL_COND_LS] = { &nbrec_table_logical_switch,
+                        nbrec_logical_switch_add_clause_name },
+    [NBCTL_COND_LSP] = { &nbrec_table_logical_switch_port,
+                         nbrec_logical_switch_port_add_clause_name },
+    [NBCTL_COND_LR] = { &nbrec_table_logical_router,
+                        nbrec_logical_router_add_clause_name },
+    [NBCTL_COND_LRP] = { &nbrec_table_logical_router_port,
+                         nbrec_logical_router_port_add_clause_name },
+};
+
+#define NONE OVN_DBCTL_COND_NONE
+#define ANY OVN_DBCTL_COND_ANY
+
+/* Commands that only need the switches, routers and ports they name.  A
+ * command must constrain every table that its prerequisites register, e.g.
+ * all of the ones in nbctl_pre_context(). */
+static const struct ovn_dbctl_cond_command nbctl_cond_commands[] = {
+    /*                                    LS    LSP   LR    LRP */
+    { "ls-add", NULL,                   { 1,    NONE, NONE, NONE } },
+    { "ls-del", NULL,                   { 1,    NONE, NONE, NONE } },
+    /* "--may-exist" needs the switch that already has the port. */
+    { "lsp-add", "--may-exist",         { 1,    2,    NONE, NONE } },
+    { "lsp-get-parent", NULL,           { ANY,  1,    ANY,  ANY } },
+    { "lsp-get-tag", NULL,              { ANY,  1,    ANY,  ANY } },
+    { "lsp-get-up", NULL,               { ANY,  1,    ANY,  ANY } },
+    { "lsp-set-enabled", NULL,          { ANY,  1,    ANY,  ANY } },
+    { "lsp-get-enabled", NULL,          { ANY,  1,    ANY,  ANY } },
+    { "lsp-set-type", NULL,             { ANY,  1,    ANY,  ANY } },
+    { "lsp-get-type", NULL,             { ANY,  1,    ANY,  ANY } },
+    { "lsp-set-options", NULL,          { ANY,  1,    ANY,  ANY } },
+    { "lsp-get-options", NULL,          { ANY,  1,    ANY,  ANY } },
+    { "lr-add", NULL,                   { ANY,  ANY,  1,    ANY } },
+    { "lr-del", NULL,                   { NONE, NONE, 1,    NONE } },
+    { NULL, NULL, { ANY } },
+};
+
+#undef NONE
+#undef ANY
+
 int
 main(int argc, char *argv[])
 {
@@ -9096,10 +10243,15 @@ main(int argc, char *argv[])
         .cmd_show_table = NULL,
         .commands = nbctl_commands,
 
+        .cond_tables = nbctl_cond_tables,
+        .n_cond_tables = NBCTL_N_COND_TABLES,
+        .cond_commands = nbctl_cond_commands,
+
         .usage = nbctl_usage,
         .add_base_prerequisites = nbctl_add_base_prerequisites,
         .pre_execute = nbctl_pre_execute,
         .post_execute = nbctl_post_execute,
+        .needs_more_txns = nbctl_import_needs_more_txns,
         .get_inactivity_probe = get_inactivity_probe,
 
         .ctx_create = nbctl_ctx_create,
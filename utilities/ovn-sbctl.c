@@ -1564,6 +1564,70 @@ static const struct ctl_command_syntax sbctl_commands[] = {
     {NULL, 0, 0, NULL, NULL, NULL, NULL, NULL, RO},
 };
 
+/* Tables registered by pre_get_info(), see "Conditional monitoring" in
+ * ovn-dbctl.h. */
+enum {
+    SBCTL_COND_CHASSIS,
+    SBCTL_COND_CHASSIS_PRIVATE,
+    SBCTL_COND_ENCAP,
+    SBCTL_COND_PORT_BINDING,
+    SBCTL_COND_LOGICAL_FLOW,
+    SBCTL_COND_LOGICAL_DP_GROUP,
+    SBCTL_COND_DATAPATH_BINDING,
+    SBCTL_COND_IP_MULTICAST,
+    SBCTL_COND_MULTICAST_GROUP,
+    SBCTL_COND_MAC_BINDING,
+    SBCTL_COND_LOAD_BALANCER,
+    SBCTL_N_COND_TABLES
+};
+
+/* Tables that no command looks up by name have no 'add_clause'. */
+static const struct ovn_dbctl_cond_table sbctl_cond_tables[] = {
+    [SBCTL_COND_CHASSIS] = { &sbrec_table_chassis,
+                             sbrec_chassis_add_clause_name },
+    [SBCTL_COND_CHASSIS_PRIVATE] = { &sbrec_table_chassis_private,
+                                     sbrec_chassis_private_add_clause_name },
+    [SBCTL_COND_ENCAP] = { &sbrec_table_encap, NULL },
+    [SBCTL_COND_PORT_BINDING] = { &sbrec_table_port_binding,
+                                  sbrec_port_binding_add_clause_logical_port },
+    [SBCTL_COND_LOGICAL_FLOW] = { &sbrec_table_logical_flow, NULL },
+    [SBCTL_COND_LOGICAL_DP_GROUP] = { &sbrec_table_logical_dp_group, NULL },
+    [SBCTL_COND_DATAPATH_BINDING] = { &sbrec_table_datapath_binding, NULL },
+    [SBCTL_COND_IP_MULTICAST] = { &sbrec_table_ip_multicast, NULL },
+    [SBCTL_COND_MULTICAST_GROUP] = { &sbrec_table_multicast_group, NULL },
+    [SBCTL_COND_MAC_BINDING] = { &sbrec_table_mac_binding, NULL },
+    [SBCTL_COND_LOAD_BALANCER] = { &sbrec_table_load_balancer, NULL },
+};
+
+#define NONE OVN_DBCTL_COND_NONE
+#define ALL OVN_DBCTL_COND_ALL
+
+/* Chassis and port binding commands, so that they do not download every
+ * logical flow.  Each command constrains all the tables registered by
+ * pre_get_info(). */
+static const struct ovn_dbctl_cond_command sbctl_cond_commands[] = {
+    /*                   Ch    ChPriv Encap PB    LF    LDPG  DB    IPM
+     *                   MG    MB    LB */
+    { "chassis-add", NULL,
+                       { 1,    NONE,  NONE, NONE, NONE, NONE, NONE, NONE,
+                         NONE, NONE, NONE } },
+    /* Deleting a chassis also deletes all the encaps it refers to. */
+    { "chassis-del", NULL,
+                       { 1,    1,     ALL,  NONE, NONE, NONE, NONE, NONE,
+                         NONE, NONE, NONE } },
+    /* The port may already be bound to any chassis. */
+    { "lsp-bind", NULL,
+                       { ALL,  NONE,  NONE, 1,    NONE, NONE, NONE, NONE,
+                         NONE, NONE, NONE } },
+    { "lsp-unbind", NULL,
+                       { NONE, NONE,  NONE, 1,    NONE, NONE, NONE, NONE,
+                         NONE, NONE, NONE } },
+    { NULL, NULL, { NONE } },
+};
+
+#undef NONE
+#undef ALL
+
 int
 main(int argc, char *argv[])
 {
@@ -1580,10 +1644,15 @@ main(int argc, char *argv[])
         .cmd_show_table = cmd_show_tables,
         .commands = sbctl_commands,
 
+        .cond_tables = sbctl_cond_tables,
+        .n_cond_tables = SBCTL_N_COND_TABLES,
+        .cond_commands = sbctl_cond_commands,
+
         .usage = sbctl_usage,
         .add_base_prerequisites = sbctl_add_base_prerequisites,
         .pre_execute = sbctl_pre_execute,
         .post_execute = NULL,
+        .needs_more_txns = NULL,
         .get_inactivity_probe = get_inactivity_probe,
 
         .ctx_create = sbctl_ctx_create,
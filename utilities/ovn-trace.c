@@ -27,6 +27,7 @@
 #include "nx-match.h"
 #include "openvswitch/dynamic-string.h"
 #include "openvswitch/json.h"
+#include "openvswitch/list.h"
 #include "openvswitch/ofp-actions.h"
 #include "openvswitch/ofp-flow.h"
 #include "openvswitch/ofp-print.h"
@@ -38,12 +39,14 @@
 #include "ovn/logical-fields.h"
 #include "lib/acl-log.h"
 #include "lib/ovn-l7.h"
+#include "lib/ovn-parallel-hmap.h"
 #include "lib/ovn-sb-idl.h"
 #include "lib/ovn-util.h"
 #include "ovsdb-idl.h"
 #include "openvswitch/poll-loop.h"
 #include "stream-ssl.h"
 #include "stream.h"
+#include "svec.h"
 #include "unixctl.h"
 #include "util.h"
 #include "random.h"
@@ -90,6 +93,12 @@ static struct ovnact_ct_lb_dst lb_dst;
 /* --select-id: "select" action member id. */
 static uint16_t select_id;
 
+/* --batch: File with one microflow per line to trace, "-" for stdin. */
+static const char *batch_file;
+
+/* --batch-threads: Number of threads used to trace the --batch microflows. */
+static int batch_n_threads = 1;
+
 /* --friendly-names, --no-friendly-names: Whether to substitute human-friendly
  * port and datapath names for the awkward UUIDs typically used in the actual
  * logical flows. */
@@ -98,6 +107,9 @@ static bool use_friendly_names = true;
 OVS_NO_RETURN static void usage(void);
 static void parse_options(int argc, char *argv[]);
 static char *trace(const char *datapath, const char *flow);
+static bool ovntrace_lookup_port(const void *dp_, const char *port_name,
+                                 unsigned int *portp);
+static void trace_batch(const char *datapath);
 static void read_db(void);
 static unixctl_cb_func ovntrace_exit;
 static unixctl_cb_func ovntrace_trace;
@@ -120,6 +132,11 @@ main(int argc, char *argv[])
             ovs_fatal(0, "non-option arguments not supported with --detach "
                       "(use --help for help)");
         }
+    } else if (batch_file) {
+        if (argc > 1) {
+            ovs_fatal(0, "at most one non-option argument is allowed with "
+                      "--batch (use --help for help)");
+        }
     } else {
         if (argc != 1 && argc != 2) {
             ovs_fatal(0, "one or two non-option arguments are required "
@@ -163,6 +180,10 @@ main(int argc, char *argv[])
             }
 
             daemonize_complete();
+            if (batch_file) {
+                trace_batch(argc > 0 ? argv[0] : NULL);
+                return 0;
+            }
             if (!get_detach()) {
                 const char *dp_s = argc > 1 ? argv[0] : NULL;
                 const char *flow_s = argv[argc - 1];
@@ -265,7 +286,9 @@ parse_options(int argc, char *argv[])
         SSL_OPTION_ENUMS,
         VLOG_OPTION_ENUMS,
         OPT_LB_DST,
-        OPT_SELECT_ID
+        OPT_SELECT_ID,
+        OPT_BATCH,
+        OPT_BATCH_THREADS
     };
     static const struct option long_options[] = {
         {"db", required_argument, NULL, OPT_DB},
@@ -284,6 +307,8 @@ parse_options(int argc, char *argv[])
         {"version", no_argument, NULL, 'V'},
         {"lb-dst", required_argument, NULL, OPT_LB_DST},
         {"select-id", required_argument, NULL, OPT_SELECT_ID},
+        {"batch", required_argument, NULL, OPT_BATCH},
+        {"batch-threads", required_argument, NULL, OPT_BATCH_THREADS},
         OVN_DAEMON_LONG_OPTIONS,
         VLOG_LONG_OPTIONS,
         STREAM_SSL_LONG_OPTIONS,
@@ -357,6 +382,17 @@ parse_options(int argc, char *argv[])
             parse_select_option(optarg);
             break;
 
+        case OPT_BATCH:
+            batch_file = optarg;
+            break;
+
+        case OPT_BATCH_THREADS:
+            if (!str_to_int(optarg, 10, &batch_n_threads)
+                || batch_n_threads < 1) {
+                ovs_fatal(0, "%s: bad number of batch threads", optarg);
+            }
+            break;
+
         case 'h':
             usage();
 
@@ -382,6 +418,10 @@ parse_options(int argc, char *argv[])
         db = default_sb_db();
     }
 
+    if (batch_file && get_detach()) {
+        ovs_fatal(0, "--batch is not supported with --detach");
+    }
+
     if (!detailed && !summary && !minimal) {
         detailed = true;
     }
@@ -393,6 +433,7 @@ usage(void)
     printf("\
 %s: OVN trace utility\n\
 usage: %s [OPTIONS] [DATAPATH] MICROFLOW\n\
+       %s [OPTIONS] --batch=FILE [DATAPATH]\n\
        %s [OPTIONS] --detach\n\
 \n\
 Output format options:\n\
@@ -401,8 +442,12 @@ Output format options:\n\
   --minimal               minimum to explain externally visible behavior\n\
   --all                   provide all forms of output\n\
 Output style options:\n\
-  --no-friendly-names     do not substitute human friendly names for UUIDs\n",
-           program_name, program_name, program_name);
+  --no-friendly-names     do not substitute human friendly names for UUIDs\n\
+Batch options:\n\
+  --batch=FILE            trace each microflow in FILE (\"-\" for stdin)\n\
+                          and print one verdict line per microflow\n\
+  --batch-threads=N       use N threads to trace the batch (default: 1)\n",
+           program_name, program_name, program_name, program_name);
     daemon_usage();
     vlog_usage();
     printf("\n\
@@ -475,6 +520,7 @@ struct ovntrace_flow {
     int priority;
     char *match_s;
     struct expr *match;
+    struct expr_program *program; /* 'match' compiled for this datapath. */
     struct ovnact *ovnacts;
     size_t ovnacts_len;
 };
@@ -1069,6 +1115,9 @@ parse_lflow_for_datapath(const struct sbrec_logical_flow *sblf,
         flow->priority = sblf->priority;
         flow->match_s = ovntrace_make_names_friendly(sblf->match);
         flow->match = match;
+        if (match) {
+            flow->program = expr_compile(match, ovntrace_lookup_port, dp);
+        }
         flow->ovnacts_len = ovnacts.size;
         flow->ovnacts = ofpbuf_steal_data(&ovnacts);
 
@@ -1295,7 +1344,7 @@ ovntrace_flow_lookup(const struct ovntrace_datapath *dp,
     VECTOR_FOR_EACH (&dp->flows, flow) {
         if (flow->pipeline == pipeline &&
             flow->table_id == table_id &&
-            expr_evaluate(flow->match, uflow, ovntrace_lookup_port, dp)) {
+            flow->program && expr_program_evaluate(flow->program, uflow)) {
             return flow;
         }
     }
@@ -3783,28 +3832,36 @@ trace_parse(const char *dp_s, const char *flow_s,
     return NULL;
 }
 
-static char *
-trace(const char *dp_s, const char *flow_s)
+/* Parses 'flow_s' (on datapath 'dp_s', if nonnull) into '*uflow' and traces
+ * it, appending the resulting tree of nodes to 'root'.  Returns NULL if
+ * successful, otherwise an error message that the caller must free. */
+static char * OVS_WARN_UNUSED_RESULT
+trace_run(const char *dp_s, const char *flow_s, struct flow *uflow,
+          struct ovs_list *root)
 {
     const struct ovntrace_datapath *dp;
-    struct flow uflow;
-    char *error = trace_parse(dp_s, flow_s, &dp, &uflow);
+    char *error = trace_parse(dp_s, flow_s, &dp, uflow);
     if (error) {
         return error;
     }
-    uint32_t in_key = uflow.regs[MFF_LOG_INPORT - MFF_REG0];
+    uint32_t in_key = uflow->regs[MFF_LOG_INPORT - MFF_REG0];
     if (!in_key) {
         return xstrdup("microflow does not specify ingress port");
     }
     const struct ovntrace_port *inport = ovntrace_port_find_by_key(dp, in_key);
     const char *inport_name = inport ? inport->friendly_name : "(unnamed)";
 
-    struct ds output = DS_EMPTY_INITIALIZER;
-
-    ds_put_cstr(&output, "# ");
-    flow_format(&output, &uflow, NULL);
-    ds_put_char(&output, '\n');
+    struct ovntrace_node *node = ovntrace_node_append(
+        root, OVNTRACE_NODE_PIPELINE, "ingress(dp=\"%s\", inport=\"%s\")",
+        dp->friendly_name, inport_name);
+    struct flow trace_uflow = *uflow;
+    trace__(dp, &trace_uflow, 0, OVNACT_P_INGRESS, &node->subs);
+    return NULL;
+}
 
+static void
+trace_open_vconn(void)
+{
     if (ovs) {
         int retval = vconn_open_block(ovs, 1 << OFP15_VERSION, 0, -1, &vconn);
         if (retval) {
@@ -3812,12 +3869,33 @@ trace(const char *dp_s, const char *flow_s)
                          ovs, ovs_strerror(retval));
         }
     }
+}
+
+static void
+trace_close_vconn(void)
+{
+    vconn_close(vconn);
+    vconn = NULL;
+}
+
+static char *
+trace(const char *dp_s, const char *flow_s)
+{
+    trace_open_vconn();
 
     struct ovs_list root = OVS_LIST_INITIALIZER(&root);
-    struct ovntrace_node *node = ovntrace_node_append(
-        &root, OVNTRACE_NODE_PIPELINE, "ingress(dp=\"%s\", inport=\"%s\")",
-        dp->friendly_name, inport_name);
-    trace__(dp, &uflow, 0, OVNACT_P_INGRESS, &node->subs);
+    struct flow uflow;
+    char *error = trace_run(dp_s, flow_s, &uflow, &root);
+    if (error) {
+        trace_close_vconn();
+        return error;
+    }
+
+    struct ds output = DS_EMPTY_INITIALIZER;
+
+    ds_put_cstr(&output, "# ");
+    flow_format(&output, &uflow, NULL);
+    ds_put_char(&output, '\n');
 
     bool multiple = (detailed + summary + minimal) > 1;
     if (detailed) {
@@ -3848,10 +3926,185 @@ trace(const char *dp_s, const char *flow_s)
 
     ovntrace_node_list_destroy(&root);
 
-    vconn_close(vconn);
+    trace_close_vconn();
 
     return ds_steal_cstr(&output);
 }
+
+/* Walks the trace tree in 'nodes' and collects its externally visible
+ * outcome: every logical port the packet is output to is added to
+ * 'outports' and '*drop_reason' is set to the last table or error node
+ * visited, which is where the packet stopped if it was not output. */
+static void
+ovntrace_node_collect_verdict(const struct ovs_list *nodes,
+                              struct svec *outports,
+                              const char **drop_reason)
+{
+    const struct ovntrace_node *sub;
+    LIST_FOR_EACH (sub, node, nodes) {
+        if (sub->type == OVNTRACE_NODE_MODIFY
+            && !strncmp(sub->name, "output(", 7)) {
+            svec_add(outports, sub->name);
+        } else if (sub->type == OVNTRACE_NODE_TABLE
+                   || sub->type == OVNTRACE_NODE_ERROR) {
+            *drop_reason = sub->name;
+        }
+        ovntrace_node_collect_verdict(&sub->subs, outports, drop_reason);
+    }
+}
+
+/* Traces 'flow_s' and returns a single line summarizing the verdict: the
+ * logical ports the packet is output to or, if there are none, the reason
+ * it was dropped.  The caller must free the returned string. */
+static char *
+trace_verdict(const char *dp_s, const char *flow_s)
+{
+    struct ds output = DS_EMPTY_INITIALIZER;
+    ds_put_format(&output, "%s => ", flow_s);
+
+    struct ovs_list root = OVS_LIST_INITIALIZER(&root);
+    struct flow uflow;
+    char *error = trace_run(dp_s, flow_s, &uflow, &root);
+    if (error) {
+        ds_put_format(&output, "error: %s", error);
+        ds_chomp(&output, '\n');
+        free(error);
+    } else {
+        struct svec outports = SVEC_EMPTY_INITIALIZER;
+        const char *drop_reason = NULL;
+
+        ovntrace_node_collect_verdict(&root, &outports, &drop_reason);
+        if (outports.n) {
+            for (size_t i = 0; i < outports.n; i++) {
+                ds_put_format(&output, "%s%s", i ? ", " : "",
+                              outports.names[i]);
+            }
+        } else {
+            ds_put_format(&output, "drop (%s)",
+                          drop_reason ? drop_reason : "no output");
+        }
+        svec_destroy(&outports);
+    }
+    ds_put_char(&output, '\n');
+
+    ovntrace_node_list_destroy(&root);
+    return ds_steal_cstr(&output);
+}
+
+struct trace_batch_entry {
+    char *flow_s;               /* Microflow to trace. */
+    char *verdict;              /* Result of trace_verdict(). */
+};
+
+struct trace_batch {
+    const char *dp_s;           /* Datapath for all entries, may be NULL. */
+    struct trace_batch_entry *entries;
+    size_t n_entries;
+};
+
+static void *
+trace_batch_thread(void *arg)
+{
+    struct worker_control *control = arg;
+
+    while (!stop_parallel_processing()) {
+        wait_for_work(control);
+        struct trace_batch *batch = control->data;
+        if (stop_parallel_processing()) {
+            return NULL;
+        }
+        if (batch) {
+            for (size_t i = control->id; i < batch->n_entries;
+                 i += control->pool->size) {
+                struct trace_batch_entry *entry = &batch->entries[i];
+                entry->verdict = trace_verdict(batch->dp_s, entry->flow_s);
+            }
+        }
+        post_completed_work(control);
+    }
+    return NULL;
+}
+
+/* Returns true if tracing one microflow may change state that affects the
+ * trace of the next one, in which case a batch must be traced serially. */
+static bool
+trace_batch_is_stateful(void)
+{
+    return ovs || n_ct_states || lb_dst.family != AF_UNSPEC;
+}
+
+/* Reads microflows from --batch, one per line, and traces all of them
+ * against the single snapshot of the southbound database that read_db()
+ * loaded, printing one verdict line per microflow in input order. */
+static void
+trace_batch(const char *dp_s)
+{
+    FILE *stream = !strcmp(batch_file, "-") ? stdin : fopen(batch_file, "r");
+    if (!stream) {
+        ovs_fatal(errno, "%s: open failed", batch_file);
+    }
+
+    struct trace_batch batch = { .dp_s = dp_s };
+    size_t allocated_entries = 0;
+    struct ds line = DS_EMPTY_INITIALIZER;
+    int line_number = 0;
+    while (!ds_get_preprocessed_line(&line, stream, &line_number)) {
+        if (!line.length) {
+            continue;
+        }
+        if (batch.n_entries >= allocated_entries) {
+            batch.entries = x2nrealloc(batch.entries, &allocated_entries,
+                                       sizeof *batch.entries);
+        }
+        batch.entries[batch.n_entries++] = (struct trace_batch_entry) {
+            .flow_s = ds_steal_cstr(&line),
+        };
+    }
+    ds_destroy(&line);
+    if (stream != stdin) {
+        fclose(stream);
+    }
+
+    int n_threads = batch_n_threads;
+    if (n_threads > 1 && trace_batch_is_stateful()) {
+        VLOG_WARN("--ovs, --ct and --lb-dst require tracing the batch "
+                  "serially, ignoring --batch-threads");
+        n_threads = 1;
+    }
+
+    struct worker_pool *pool = NULL;
+    if (n_threads > 1) {
+        update_worker_pool(n_threads, &pool, trace_batch_thread);
+    }
+
+    if (pool) {
+        for (size_t i = 0; i < pool->size; i++) {
+            pool->controls[i].data = &batch;
+        }
+        run_pool(pool);
+    } else {
+        struct ovnact_ct_lb_dst orig_lb_dst = lb_dst;
+
+        trace_open_vconn();
+        for (size_t i = 0; i < batch.n_entries; i++) {
+            struct trace_batch_entry *entry = &batch.entries[i];
+
+            /* Every microflow starts from the same --ct and --lb-dst
+             * settings, as if it was traced on its own. */
+            ct_state_idx = 0;
+            lb_dst = orig_lb_dst;
+            entry->verdict = trace_verdict(dp_s, entry->flow_s);
+        }
+        trace_close_vconn();
+    }
+
+    for (size_t i = 0; i < batch.n_entries; i++) {
+        fputs(batch.entries[i].verdict, stdout);
+        free(batch.entries[i].verdict);
+        free(batch.entries[i].flow_s);
+    }
+    free(batch.entries);
+}
 
 static void
 ovntrace_exit(struct unixctl_conn *conn, int argc OVS_UNUSED,